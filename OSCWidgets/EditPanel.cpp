@@ -22,6 +22,7 @@
 #include "ToyButton.h"
 #include "ToyMath.h"
 #include "Utils.h"
+#include "Wavetable.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -213,6 +214,64 @@ EditPanel::EditPanel(EditPanelClient &client, QWidget *parent)
   connect(m_BPM, SIGNAL(editingFinished()), this, SLOT(onEditingFinished()));
   layout->addWidget(m_BPM, row, 1);
 
+  ++row;
+  m_WaveformLabel = new QLabel(tr("Wave"), this);
+  layout->addWidget(m_WaveformLabel, row, 0);
+  m_Waveform = new QComboBox(this);
+  m_Waveform->addItem(tr("Sine"), static_cast<int>(Wavetable::WAVEFORM_SINE));
+  m_Waveform->addItem(tr("Triangle"), static_cast<int>(Wavetable::WAVEFORM_TRIANGLE));
+  m_Waveform->addItem(tr("Saw"), static_cast<int>(Wavetable::WAVEFORM_SAW));
+  m_Waveform->addItem(tr("Square"), static_cast<int>(Wavetable::WAVEFORM_SQUARE));
+  m_Waveform->addItem(tr("Random"), static_cast<int>(Wavetable::WAVEFORM_RANDOM));
+  SetToolTips(tr("LFO shape"), m_WaveformLabel, m_Waveform);
+  connect(m_Waveform, SIGNAL(currentIndexChanged(int)), this, SLOT(onWaveformChanged(int)));
+  layout->addWidget(m_Waveform, row, 1);
+
+  ++row;
+  m_PhaseDutyLabel = new QLabel(tr("Phase/Duty"), this);
+  SetToolTips(tr("Phase offset in degrees, duty cycle in percent"), m_PhaseDutyLabel, 0);
+  layout->addWidget(m_PhaseDutyLabel, row, 0);
+  m_Phase = new QLineEdit(this);
+  m_Phase->setToolTip(tr("Phase offset in degrees"));
+  connect(m_Phase, SIGNAL(editingFinished()), this, SLOT(onEditingFinished()));
+  layout->addWidget(m_Phase, row, 1);
+  m_Duty = new QLineEdit(this);
+  m_Duty->setToolTip(tr("Duty cycle in percent"));
+  connect(m_Duty, SIGNAL(editingFinished()), this, SLOT(onEditingFinished()));
+  layout->addWidget(m_Duty, row, 2);
+
+  ++row;
+  m_ClockLabel = new QLabel(tr("Clock"), this);
+  layout->addWidget(m_ClockLabel, row, 0);
+  m_Clock = new QLineEdit(this);
+  SetToolTips(tr("Widgets with the same clock name share tempo, phase and play/pause, across all toys\nFollow it over OSC with /oscwidgets/clock/<name>/bpm, tap, play and pause"), m_ClockLabel, m_Clock);
+  connect(m_Clock, SIGNAL(editingFinished()), this, SLOT(onEditingFinished()));
+  layout->addWidget(m_Clock, row, 1);
+
+  ++row;
+  m_SeedLabel = new QLabel(tr("Seed"), this);
+  layout->addWidget(m_SeedLabel, row, 0);
+  m_Seed = new QLineEdit(this);
+  SetToolTips(tr("Replay the same random sequence every time play starts\nLeave empty for a different sequence each time"), m_SeedLabel, m_Seed);
+  connect(m_Seed, SIGNAL(editingFinished()), this, SLOT(onEditingFinished()));
+  layout->addWidget(m_Seed, row, 1);
+
+  ++row;
+  m_LookaheadLabel = new QLabel(tr("Lookahead"), this);
+  layout->addWidget(m_LookaheadLabel, row, 0);
+  m_Lookahead = new QLineEdit(this);
+  SetToolTips(tr("Milliseconds to send output ahead of time, in timetagged OSC bundles\nOnly for receivers that schedule bundles by timetag, leave empty to send immediately"), m_LookaheadLabel, m_Lookahead);
+  connect(m_Lookahead, SIGNAL(editingFinished()), this, SLOT(onEditingFinished()));
+  layout->addWidget(m_Lookahead, row, 1);
+
+  ++row;
+  m_PaintedCellsLabel = new QLabel(tr("Paint Cells"), this);
+  layout->addWidget(m_PaintedCellsLabel, row, 0);
+  m_PaintedCells = new QCheckBox(this);
+  SetToolTips(tr("Draw all cells of this grid as one widget, so large layouts show and resize faster\nEach cell keeps a hidden widget for its settings, and only shows it while being edited"), m_PaintedCellsLabel, m_PaintedCells);
+  connect(m_PaintedCells, SIGNAL(stateChanged(int)), this, SLOT(onPaintedCellsStateChanged(int)));
+  layout->addWidget(m_PaintedCells, row, 1, 1, 2);
+
   ++row;
   m_LabelPathLabel = new QLabel(tr("OSC Label"), this);
   layout->addWidget(m_LabelPathLabel, row, 0);
@@ -794,6 +853,148 @@ void EditPanel::SetBPMEnabled(bool b)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void EditPanel::GetWaveform(QString &waveform) const
+{
+  QVariant v = m_Waveform->itemData(m_Waveform->currentIndex());
+  waveform = Wavetable::GetName(static_cast<Wavetable::EnumWaveform>(v.isValid() ? v.toInt() : 0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetWaveform(const QString &waveform)
+{
+  m_Waveform->setCurrentIndex(qMax(0, m_Waveform->findData(static_cast<int>(Wavetable::GetWaveformForName(waveform)))));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::GetPhase(QString &n) const
+{
+  n = m_Phase->text();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetPhase(const QString &n)
+{
+  m_Phase->setText(n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::GetDuty(QString &n) const
+{
+  n = m_Duty->text();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetDuty(const QString &n)
+{
+  m_Duty->setText(n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetWaveformEnabled(bool b)
+{
+  m_WaveformLabel->setEnabled(b);
+  m_Waveform->setEnabled(b);
+  m_PhaseDutyLabel->setEnabled(b);
+  m_Phase->setEnabled(b);
+  m_Duty->setEnabled(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::GetClock(QString &clock) const
+{
+  clock = m_Clock->text();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetClock(const QString &clock)
+{
+  m_Clock->setText(clock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetClockEnabled(bool b)
+{
+  m_ClockLabel->setEnabled(b);
+  m_Clock->setEnabled(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::GetSeed(QString &seed) const
+{
+  seed = m_Seed->text();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetSeed(const QString &seed)
+{
+  m_Seed->setText(seed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetSeedEnabled(bool b)
+{
+  m_SeedLabel->setEnabled(b);
+  m_Seed->setEnabled(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::GetLookahead(QString &lookahead) const
+{
+  lookahead = m_Lookahead->text();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetLookahead(const QString &lookahead)
+{
+  m_Lookahead->setText(lookahead);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetLookaheadEnabled(bool b)
+{
+  m_LookaheadLabel->setEnabled(b);
+  m_Lookahead->setEnabled(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool EditPanel::GetPaintedCells() const
+{
+  return m_PaintedCells->isChecked();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetPaintedCells(bool b)
+{
+  m_PaintedCells->setChecked(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void EditPanel::SetPaintedCellsEnabled(bool b)
+{
+  m_PaintedCellsLabel->setEnabled(b);
+  m_PaintedCells->setEnabled(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void EditPanel::SetHelpText(const QString &text)
 {
   m_Help->setText(text);
@@ -816,6 +1017,13 @@ void EditPanel::onGridChanged(int /*value*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void EditPanel::onWaveformChanged(int /*index*/)
+{
+  emit edited();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void EditPanel::onEditingFinished()
 {
   emit edited();
@@ -830,6 +1038,13 @@ void EditPanel::onHiddenStateChanged(int /*state*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void EditPanel::onPaintedCellsStateChanged(int /*state*/)
+{
+  emit edited();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void EditPanel::onPathTextChanged(const QString & /*text*/)
 {
   if (m_IgnoreEdits == 0)
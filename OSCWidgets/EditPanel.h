@@ -137,6 +137,25 @@ public:
   virtual void GetBPM(QString &n) const;
   virtual void SetBPM(const QString &n);
   virtual void SetBPMEnabled(bool b);
+  virtual void GetWaveform(QString &waveform) const;
+  virtual void SetWaveform(const QString &waveform);
+  virtual void GetPhase(QString &n) const;
+  virtual void SetPhase(const QString &n);
+  virtual void GetDuty(QString &n) const;
+  virtual void SetDuty(const QString &n);
+  virtual void SetWaveformEnabled(bool b);
+  virtual void GetClock(QString &clock) const;
+  virtual void SetClock(const QString &clock);
+  virtual void SetClockEnabled(bool b);
+  virtual void GetSeed(QString &seed) const;
+  virtual void SetSeed(const QString &seed);
+  virtual void SetSeedEnabled(bool b);
+  virtual void GetLookahead(QString &lookahead) const;
+  virtual void SetLookahead(const QString &lookahead);
+  virtual void SetLookaheadEnabled(bool b);
+  virtual bool GetPaintedCells() const;
+  virtual void SetPaintedCells(bool b);
+  virtual void SetPaintedCellsEnabled(bool b);
   virtual void SetHelpText(const QString &text);
 
 signals:
@@ -145,8 +164,10 @@ signals:
 
 private slots:
   void onGridChanged(int value);
+  void onWaveformChanged(int index);
   void onEditingFinished();
   void onHiddenStateChanged(int state);
+  void onPaintedCellsStateChanged(int state);
   void onPathTextChanged(const QString &text);
   void onPath2TextChanged(const QString &text);
   void onLocalStateChanged(int state);
@@ -191,6 +212,19 @@ protected:
   QLineEdit *m_Max2;
   QLabel *m_BPMLabel;
   QLineEdit *m_BPM;
+  QLabel *m_WaveformLabel;
+  QComboBox *m_Waveform;
+  QLabel *m_PhaseDutyLabel;
+  QLineEdit *m_Phase;
+  QLineEdit *m_Duty;
+  QLabel *m_ClockLabel;
+  QLineEdit *m_Clock;
+  QLabel *m_SeedLabel;
+  QLineEdit *m_Seed;
+  QLabel *m_LookaheadLabel;
+  QLineEdit *m_Lookahead;
+  QLabel *m_PaintedCellsLabel;
+  QCheckBox *m_PaintedCells;
   QLabel *m_HiddenLabel;
   QCheckBox *m_Hidden;
   QLabel *m_Help;
@@ -41,6 +41,8 @@ FadeButton::FadeButton(bool touchEnabled, QWidget *parent)
 
 FadeButton::~FadeButton()
 {
+  FS.Unsubscribe(*this);
+
   for (size_t i = 0; i < NUM_IMAGES; i++)
     SetImagePath(i, QString());
 }
@@ -50,14 +52,15 @@ FadeButton::~FadeButton()
 void FadeButton::Construct(bool touchEnabled)
 {
   m_Click = 0;
+  m_Clicking = false;
+  m_ClickElapsed = 0;
   m_Hover = 0;
+  m_Hovering = false;
   m_ImageIndex = 0;
+  m_LiveResize = false;
+  m_ImagesDeferred = false;
 
-  m_ClickTimer = new QTimer(this);
-  connect(m_ClickTimer, SIGNAL(timeout()), this, SLOT(onClickTimeout()));
-
-  m_HoverTimer = new QTimer(this);
-  connect(m_HoverTimer, SIGNAL(timeout()), this, SLOT(onHoverTimeout()));
+  FS.Subscribe(*this, QStringLiteral("FadeButton"), ANIMATION_MS, /*active*/ false);
 
   connect(this, SIGNAL(pressed()), this, SLOT(onPressed()));
   connect(this, SIGNAL(released()), this, SLOT(onReleased()));
@@ -100,7 +103,11 @@ void FadeButton::SetImagePath(size_t index, const QString &imagePath)
     {
       PMC.Destroy(img.path);
       img.path = imagePath;
+      img.pixmap = QPixmap();
+      img.resizeSource = QPixmap();
       PMC.Create(img.path);
+      if (!img.path.isEmpty())
+        connect(&PMC, SIGNAL(ready(const QString &)), this, SLOT(onImageReady(const QString &)), Qt::UniqueConnection);
       UpdateImage(index);
     }
   }
@@ -124,7 +131,37 @@ void FadeButton::UpdateImage(size_t index)
   if (index < NUM_IMAGES)
   {
     sImage &img = m_Images[index];
-    PMC.GetScaledToFill(img.path, size(), img.pixmap);
+
+    // nobody can see it, so scale once it is shown
+    if (!isVisible())
+    {
+      m_ImagesDeferred = true;
+      return;
+    }
+
+    if (m_LiveResize)
+    {
+      // a cheap stretch for every step of the drag, the settled size is scaled properly
+      if (img.resizeSource.isNull())
+        img.resizeSource = img.pixmap;
+      if (!img.resizeSource.isNull())
+      {
+        qreal dpr = devicePixelRatioF();
+        img.pixmap = img.resizeSource.scaled(PixmapCache::GetFillSize(img.resizeSource.size(), size() * dpr), Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        img.pixmap.setDevicePixelRatio(dpr);
+      }
+      if (m_ImageIndex == index)
+        update();
+      return;
+    }
+
+    img.resizeSource = QPixmap();
+
+    // keep drawing the previous size until the new one is scaled
+    QPixmap pixmap;
+    img.pending = !PMC.GetScaledToFill(img.path, size(), devicePixelRatioF(), pixmap);
+    if (!img.pending)
+      img.pixmap = pixmap;
     if (m_ImageIndex == index)
       update();
   }
@@ -132,18 +169,39 @@ void FadeButton::UpdateImage(size_t index)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void FadeButton::SetLiveResize(bool b)
+{
+  if (m_LiveResize != b)
+  {
+    m_LiveResize = b;
+
+    // settled, so catch up on the font and image work skipped during the drag
+    if (!m_LiveResize)
+    {
+      AutoSizeFont();
+      for (size_t i = 0; i < NUM_IMAGES; i++)
+        UpdateImage(i);
+      update();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void FadeButton::StartClick()
 {
-  m_ClickTimestamp.Start();
-  m_ClickTimer->start(16);
-  onClickTimeout();
+  m_ClickElapsed = 0;
+  m_Clicking = true;
+  UpdateAnimating();
+  UpdateClick(0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void FadeButton::StopClick()
 {
-  m_ClickTimer->stop();
+  m_Clicking = false;
+  UpdateAnimating();
   SetClick(0);
 }
 
@@ -162,6 +220,9 @@ void FadeButton::SetClick(float percent)
 
 void FadeButton::Flash()
 {
+  if (!isVisible())
+    return;
+
   SetHover(1.0);
   StartHover();
 }
@@ -170,10 +231,10 @@ void FadeButton::Flash()
 
 void FadeButton::StartHover()
 {
-  if (!m_HoverTimer->isActive())
+  if (!m_Hovering)
   {
-    m_HoverTimestamp.Start();
-    m_HoverTimer->start(16);
+    m_Hovering = true;
+    UpdateAnimating();
   }
 }
 
@@ -181,7 +242,8 @@ void FadeButton::StartHover()
 
 void FadeButton::StopHover()
 {
-  m_HoverTimer->stop();
+  m_Hovering = false;
+  UpdateAnimating();
   SetHover(0);
 }
 
@@ -246,9 +308,177 @@ void FadeButton::RenderBackground(QPainter &painter, QRectF &r)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void FadeButton::GetBackgroundLayer(float brightness, QPixmap &layer)
+{
+  // the background and image only vary with size, palette, image and brightness, so each quantized
+  // brightness level is rasterized once and shared by every button that looks the same
+  int level = qMax(0, qRound(brightness * BRIGHTNESS_LEVELS));
+  const sImage &img = m_Images[m_ImageIndex];
+  QColor color(palette().color(QPalette::Button));
+  qreal dpr = devicePixelRatioF();
+
+  qint64 imageKey = (img.pixmap.isNull() ? (img.pending ? -1 : 0) : img.pixmap.cacheKey());
+  QString key = QStringLiteral("FadeButton:%1:%2x%3@%4:%5:%6:%7").arg(QLatin1String(metaObject()->className())).arg(width()).arg(height()).arg(dpr).arg(color.rgba()).arg(imageKey).arg(level);
+  if (QPixmapCache::find(key, &layer))
+    return;
+
+  layer = QPixmap(qCeil(width() * dpr), qCeil(height() * dpr));
+  layer.setDevicePixelRatio(dpr);
+  layer.fill(Qt::transparent);
+
+  qreal b = (level / static_cast<qreal>(BRIGHTNESS_LEVELS));
+  if (b > 0)
+  {
+    qreal t = (b * BUTTON_BRIGHTESS);
+    color.setRedF(qMin(color.redF() + t, 1.0));
+    color.setGreenF(qMin(color.greenF() + t, 1.0));
+    color.setBlueF(qMin(color.blueF() + t, 1.0));
+  }
+
+  QRectF r(rect());
+  r.adjust(1, 1, -1, -1);
+
+  QPainter painter(&layer);
+  painter.setRenderHints(QPainter::Antialiasing);
+  painter.setBrush(color);
+  painter.setPen(Qt::NoPen);
+  RenderBackground(painter, r);
+
+  if (img.pixmap.isNull() && img.pending)
+  {
+    QColor placeholder(palette().color(QPalette::ButtonText));
+    placeholder.setAlpha(24);
+    painter.setBrush(QBrush(placeholder, Qt::BDiagPattern));
+    RenderBackground(painter, r);
+  }
+  else if (!img.pixmap.isNull())
+  {
+    painter.setOpacity(1.0 - (b * 0.5));
+    DrawCenteredPixmap(painter, r, img.pixmap);
+  }
+
+  painter.end();
+  QPixmapCache::insert(key, layer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::RenderText(QPainter &painter, const QRectF &r, const QColor &textColor)
+{
+  UpdateTextLayout(r.width());
+
+  bool hasText = !m_TextLayout.text.isEmpty();
+  bool hasLabel = !m_TextLayout.label.isEmpty();
+  if (!hasText && !hasLabel)
+    return;
+
+  painter.setPen(textColor);
+
+  if (hasText && hasLabel)
+  {
+    // both text and label text, split by their relative heights
+    qreal labelHeight = m_TextLayout.staticLabel.size().height();
+    qreal h = ((labelHeight > 0) ? (r.height() * 0.5 * (m_TextLayout.staticText.size().height() / labelHeight)) : (r.height() * 0.5));
+    DrawStaticText(painter, QRectF(r.x(), r.y(), r.width(), h), m_TextLayout.staticText);
+    DrawStaticText(painter, QRectF(r.x(), r.y() + h, r.width(), r.height() - h), m_TextLayout.staticLabel);
+  }
+  else if (hasText)
+  {
+    // just text centered
+    DrawStaticText(painter, r, m_TextLayout.staticText);
+  }
+  else
+  {
+    // just label text centered
+    DrawStaticText(painter, r, m_TextLayout.staticLabel);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::UpdateTextLayout(qreal width)
+{
+  QString str(text());
+  bool rebuild = (m_TextLayout.width != width);
+  m_TextLayout.width = width;
+
+  if (rebuild || m_TextLayout.text != str)
+  {
+    m_TextLayout.text = str;
+    InitStaticText(m_TextLayout.text, width, m_TextLayout.staticText);
+  }
+
+  if (rebuild || m_TextLayout.label != m_Label)
+  {
+    m_TextLayout.label = m_Label;
+    InitStaticText(m_TextLayout.label, width, m_TextLayout.staticLabel);
+  }
+
+  // lays out now rather than on first draw, so the split above can use the sizes
+  if (rebuild)
+  {
+    m_TextLayout.staticText.prepare(QTransform(), font());
+    m_TextLayout.staticLabel.prepare(QTransform(), font());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::DrawCenteredPixmap(QPainter &painter, const QRectF &r, const QPixmap &pixmap)
+{
+  // cached pixmaps are scaled for the screen, so center by their size in device independent pixels
+  QSizeF size(pixmap.deviceIndependentSize());
+  painter.drawPixmap(QPointF(r.x() + qRound((r.width() - size.width()) * 0.5), r.y() + qRound((r.height() - size.height()) * 0.5)), pixmap);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::InitStaticText(const QString &str, qreal width, QStaticText &staticText)
+{
+  QString plain(str);
+  plain.replace(QLatin1Char('\n'), QChar::LineSeparator);
+
+  staticText.setTextFormat(Qt::PlainText);
+  staticText.setTextOption(QTextOption(Qt::AlignHCenter));
+  staticText.setTextWidth(width);
+  staticText.setText(plain);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::DrawStaticText(QPainter &painter, const QRectF &r, const QStaticText &staticText)
+{
+  QSizeF size(staticText.size());
+  QPointF pos(r.x(), r.y() + (r.height() - size.height()) * 0.5);
+
+  if (size.width() > r.width() || size.height() > r.height())
+  {
+    // overflowing text is clipped, as drawText would
+    painter.save();
+    painter.setClipRect(r, Qt::IntersectClip);
+    painter.drawStaticText(pos, staticText);
+    painter.restore();
+  }
+  else
+    painter.drawStaticText(pos, staticText);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::changeEvent(QEvent *event)
+{
+  if (event && event->type() == QEvent::FontChange)
+    m_TextLayout.width = -1;
+
+  QPushButton::changeEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void FadeButton::resizeEvent(QResizeEvent *event)
 {
-  AutoSizeFont();
+  if (!m_LiveResize)
+    AutoSizeFont();
 
   for (size_t i = 0; i < NUM_IMAGES; i++)
     UpdateImage(i);
@@ -258,40 +488,50 @@ void FadeButton::resizeEvent(QResizeEvent *event)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void FadeButton::showEvent(QShowEvent *event)
+{
+  QPushButton::showEvent(event);
+
+  if (m_ImagesDeferred)
+  {
+    m_ImagesDeferred = false;
+    for (size_t i = 0; i < NUM_IMAGES; i++)
+      UpdateImage(i);
+  }
+
+  UpdateAnimating();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::hideEvent(QHideEvent *event)
+{
+  // hover and click fades are only for show, drop them rather than tick them offscreen
+  QPushButton::hideEvent(event);
+  m_Clicking = false;
+  m_Click = 0;
+  m_Hovering = false;
+  m_Hover = 0;
+  UpdateAnimating();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void FadeButton::paintEvent(QPaintEvent * /*event*/)
 {
   QRectF r(rect());
   r.adjust(1, 1, -1, -1);
 
-  QPainter painter(this);
-  painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
-
   float brightness = m_Click;
   if (m_Hover > 0)
     brightness += (m_Hover * 0.2f);
 
-  if (brightness > 0)
-  {
-    QColor color(palette().color(QPalette::Button));
-    qreal t = (brightness * BUTTON_BRIGHTESS);
-    color.setRedF(qMin(color.redF() + t, 1.0));
-    color.setGreenF(qMin(color.greenF() + t, 1.0));
-    color.setBlueF(qMin(color.blueF() + t, 1.0));
-    painter.setBrush(color);
-  }
-  else
-    painter.setBrush(palette().color(QPalette::Button));
+  QPixmap layer;
+  GetBackgroundLayer(brightness, layer);
 
-  painter.setPen(Qt::NoPen);
-  RenderBackground(painter, r);
-
-  sImage &img = m_Images[m_ImageIndex];
-  if (!img.pixmap.isNull())
-  {
-    painter.setOpacity(1.0 - (brightness * 0.5));
-    painter.drawPixmap(r.x() + qRound((r.width() - img.pixmap.width()) * 0.5), r.y() + qRound((r.height() - img.pixmap.height()) * 0.5), img.pixmap);
-    painter.setOpacity(1.0);
-  }
+  QPainter painter(this);
+  painter.drawPixmap(0, 0, layer);
+  painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
 
   if (m_Hover > 0)
   {
@@ -304,35 +544,7 @@ void FadeButton::paintEvent(QPaintEvent * /*event*/)
   if (!isEnabled())
     textColor = textColor.darker(150);
 
-  if (!text().isEmpty())
-  {
-    if (m_Label.isEmpty())
-    {
-      // just text centered
-      painter.setPen(textColor);
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap, text());
-    }
-    else
-    {
-      // both text and label text
-      QRectF textRect;
-      painter.setPen(textColor);
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap | Qt::TextDontPrint, text(), &textRect);
-
-      QRectF labelRect;
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap | Qt::TextDontPrint, m_Label, &labelRect);
-
-      qreal h = (r.height() * 0.5 * (textRect.height() / labelRect.height()));
-      painter.drawText(QRectF(r.x(), r.y(), r.width(), h), Qt::AlignCenter | Qt::TextWordWrap, text());
-      painter.drawText(QRectF(r.x(), r.y() + h, r.width(), r.height() - h), Qt::AlignCenter | Qt::TextWordWrap, m_Label);
-    }
-  }
-  else if (!m_Label.isEmpty())
-  {
-    // just label text centered
-    painter.setPen(textColor);
-    painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap, m_Label);
-  }
+  RenderText(painter, r, textColor);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -352,23 +564,35 @@ void FadeButton::onReleased()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeButton::onClickTimeout()
+void FadeButton::onImageReady(const QString &path)
+{
+  for (size_t i = 0; i < NUM_IMAGES; i++)
+  {
+    if (m_Images[i].pending && m_Images[i].path == path)
+      UpdateImage(i);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::UpdateClick(unsigned int ms)
 {
-  int elapsed = m_ClickTimestamp.GetElapsed();
-  float t = (1.0f - elapsed / static_cast<float>(BUTTON_CLICK_MS));
+  m_ClickElapsed += ms;
+  float t = (1.0f - m_ClickElapsed / static_cast<float>(BUTTON_CLICK_MS));
   if (t <= 0)
   {
     t = 0;
-    m_ClickTimer->stop();
+    m_Clicking = false;
+    UpdateAnimating();
   }
   SetClick(t);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeButton::onHoverTimeout()
+void FadeButton::UpdateHover(unsigned int ms)
 {
-  float t = (m_HoverTimestamp.Restart() * BUTTON_HOVER_SPEED);
+  float t = (ms * BUTTON_HOVER_SPEED);
 
   if (underMouse())
   {
@@ -376,7 +600,8 @@ void FadeButton::onHoverTimeout()
     if (hover >= 1.0f)
     {
       hover = 1.0f;
-      m_HoverTimer->stop();
+      m_Hovering = false;
+      UpdateAnimating();
     }
     SetHover(hover);
   }
@@ -386,7 +611,8 @@ void FadeButton::onHoverTimeout()
     if (hover <= 0)
     {
       hover = 0;
-      m_HoverTimer->stop();
+      m_Hovering = false;
+      UpdateAnimating();
     }
     SetHover(hover);
   }
@@ -394,6 +620,31 @@ void FadeButton::onHoverTimeout()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool FadeButton::IsAnimating() const
+{
+  return (m_Clicking || m_Hovering);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::UpdateAnimating()
+{
+  FS.SetActive(*this, IsAnimating() && isVisible());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeButton::FrameSchedulerClient_Tick(unsigned int ms)
+{
+  if (m_Clicking)
+    UpdateClick(ms);
+
+  if (m_Hovering)
+    UpdateHover(ms);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool FadeButton::event(QEvent *event)
 {
   if (event)
@@ -30,16 +30,21 @@
 #include "EosTimer.h"
 #endif
 
+#ifndef FRAME_SCHEDULER_H
+#include "FrameScheduler.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
-class FadeButton : public QPushButton
+class FadeButton : public QPushButton, protected FrameScheduler::FrameSchedulerClient
 {
   Q_OBJECT
 
 public:
   enum EnumConstants
   {
-    NUM_IMAGES = 2
+    NUM_IMAGES = 2,
+    BRIGHTNESS_LEVELS = 32  // per unit of brightness
   };
 
   FadeButton(QWidget *parent);
@@ -54,13 +59,16 @@ public:
   virtual void Press(bool user = true);
   virtual void Release(bool user = true);
   virtual void Flash();
+  virtual bool GetLiveResize() const { return m_LiveResize; }
+  virtual void SetLiveResize(bool b);
   virtual bool event(QEvent *event);
 
+  static void DrawCenteredPixmap(QPainter &painter, const QRectF &r, const QPixmap &pixmap);
+
 private slots:
   void onPressed();
   void onReleased();
-  void onClickTimeout();
-  void onHoverTimeout();
+  void onImageReady(const QString &path);
 
 private:
   void Construct(bool touchEnabled);
@@ -68,20 +76,43 @@ private:
 protected:
   struct sImage
   {
+    sImage()
+      : pending(false)
+    {
+    }
     QString path;
     QPixmap pixmap;
+    QPixmap resizeSource;  // last properly scaled pixmap, stretched while a resize is live
+    bool pending;          // still decoding or scaling, placeholder drawn if there is no pixmap yet
+  };
+
+  // word wrapped layouts of text() and m_Label, rebuilt only when the text, width or font changes
+  struct sTextLayout
+  {
+    sTextLayout()
+      : width(-1)
+    {
+    }
+
+    QString text;
+    QString label;
+    qreal width;
+    QStaticText staticText;
+    QStaticText staticLabel;
   };
 
   float m_Click;
-  QTimer *m_ClickTimer;
-  EosTimer m_ClickTimestamp;
+  bool m_Clicking;
+  unsigned int m_ClickElapsed;
   float m_Hover;
-  QTimer *m_HoverTimer;
+  bool m_Hovering;
   bool m_Hovered;
-  EosTimer m_HoverTimestamp;
   QString m_Label;
   sImage m_Images[NUM_IMAGES];
   size_t m_ImageIndex;
+  sTextLayout m_TextLayout;
+  bool m_LiveResize;
+  bool m_ImagesDeferred;
 
   virtual void StartClick();
   virtual void StopClick();
@@ -89,11 +120,25 @@ protected:
   virtual void StartHover();
   virtual void StopHover();
   virtual void SetHover(float percent);
+  virtual void UpdateClick(unsigned int ms);
+  virtual void UpdateHover(unsigned int ms);
+  virtual bool IsAnimating() const;
+  virtual void UpdateAnimating();
+  virtual void FrameSchedulerClient_Tick(unsigned int ms);
   virtual void AutoSizeFont();
   virtual void UpdateImage(size_t index);
   virtual void RenderBackground(QPainter &painter, QRectF &r);
+  virtual void GetBackgroundLayer(float brightness, QPixmap &layer);
+  virtual void RenderText(QPainter &painter, const QRectF &r, const QColor &textColor);
+  virtual void UpdateTextLayout(qreal width);
+  virtual void changeEvent(QEvent *event);
   virtual void resizeEvent(QResizeEvent *event);
+  virtual void showEvent(QShowEvent *event);
+  virtual void hideEvent(QHideEvent *event);
   virtual void paintEvent(QPaintEvent *event);
+
+  static void InitStaticText(const QString &str, qreal width, QStaticText &staticText);
+  static void DrawStaticText(QPainter &painter, const QRectF &r, const QStaticText &staticText);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
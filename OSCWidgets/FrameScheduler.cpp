@@ -0,0 +1,356 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "FrameScheduler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+FrameScheduler *FrameScheduler::sm_Instance = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+FrameScheduler::FrameScheduler()
+  : m_ActiveCount(0)
+  , m_Ticking(false)
+  , m_Dirty(false)
+  , m_StatsStartNS(0)
+  , m_Wakeups(0)
+{
+  m_Clock.start();
+
+  m_Timer = new QTimer(this);
+  m_Timer->setSingleShot(true);
+  m_Timer->setTimerType(Qt::PreciseTimer);
+  connect(m_Timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FrameScheduler::~FrameScheduler()
+{
+  m_Timer->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FrameScheduler::sSubscriber *FrameScheduler::Find(FrameSchedulerClient &client)
+{
+  // buttons activate and deactivate in bulk on every tab switch, so no scanning
+  SUBSCRIBER_INDICIES::const_iterator i = m_Indicies.constFind(&client);
+  return ((i != m_Indicies.constEnd()) ? &m_List[i.value()] : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const FrameScheduler::sSubscriber *FrameScheduler::Find(FrameSchedulerClient &client) const
+{
+  SUBSCRIBER_INDICIES::const_iterator i = m_Indicies.constFind(&client);
+  return ((i != m_Indicies.constEnd()) ? &m_List[i.value()] : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::Subscribe(FrameSchedulerClient &client, const QString &name, unsigned int intervalMS, bool active)
+{
+  sSubscriber *subscriber = Find(client);
+  if (subscriber)
+  {
+    if (subscriber->stats.active)
+      m_ActiveCount--;
+  }
+  else
+  {
+    m_Indicies.insert(&client, m_List.size());
+    m_List.push_back(sSubscriber());
+    subscriber = &m_List.back();
+    subscriber->client = &client;
+  }
+
+  subscriber->lastNS = m_Clock.nsecsElapsed();
+  subscriber->stats.name = name;
+  subscriber->stats.intervalMS = qMax(1u, intervalMS);
+  subscriber->stats.active = active;
+
+  if (active)
+  {
+    m_ActiveCount++;
+    Schedule(*subscriber);
+  }
+  else if (m_ActiveCount == 0 && !m_Ticking)
+    m_Timer->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::Unsubscribe(FrameSchedulerClient &client)
+{
+  SUBSCRIBER_INDICIES::iterator i = m_Indicies.find(&client);
+  if (i == m_Indicies.end())
+    return;
+
+  size_t index = i.value();
+  m_Indicies.erase(i);
+
+  sSubscriber &subscriber = m_List[index];
+  if (subscriber.stats.active)
+    m_ActiveCount--;
+
+  if (m_Ticking)
+  {
+    // removed after the current tick completes
+    subscriber.client = 0;
+    subscriber.stats.active = false;
+    m_Dirty = true;
+  }
+  else
+  {
+    RemoveAt(index);
+
+    if (m_ActiveCount == 0)
+      m_Timer->stop();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::SetInterval(FrameSchedulerClient &client, unsigned int intervalMS)
+{
+  sSubscriber *subscriber = Find(client);
+  if (subscriber)
+  {
+    intervalMS = qMax(1u, intervalMS);
+    if (subscriber->stats.intervalMS != intervalMS)
+    {
+      subscriber->stats.intervalMS = intervalMS;
+      Schedule(*subscriber);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::SetActive(FrameSchedulerClient &client, bool b)
+{
+  sSubscriber *subscriber = Find(client);
+  if (subscriber && subscriber->stats.active != b)
+  {
+    subscriber->stats.active = b;
+    if (b)
+    {
+      m_ActiveCount++;
+      subscriber->lastNS = m_Clock.nsecsElapsed();
+      Schedule(*subscriber);
+    }
+    else if (--m_ActiveCount == 0 && !m_Ticking)
+      m_Timer->stop();
+
+    // otherwise a pending timeout may now be early, which only costs one empty pass
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool FrameScheduler::IsActive(FrameSchedulerClient &client) const
+{
+  const sSubscriber *subscriber = Find(client);
+  return (subscriber && subscriber->stats.active);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::GetStats(STATS &stats) const
+{
+  stats.clear();
+  stats.reserve(m_List.size());
+  for (SUBSCRIBERS::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+  {
+    if (i->client)
+      stats.push_back(i->stats);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::ResetStats()
+{
+  for (SUBSCRIBERS::iterator i = m_List.begin(); i != m_List.end(); i++)
+  {
+    i->stats.ticks = 0;
+    i->stats.costNS = 0;
+    i->stats.maxCostNS = 0;
+  }
+
+  m_StatsStartNS = m_Clock.nsecsElapsed();
+  m_Wakeups = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::Schedule()
+{
+  // rescheduled once the current tick completes
+  if (m_Ticking)
+    return;
+
+  bool hasNext = false;
+  qint64 nextNS = 0;
+  for (SUBSCRIBERS::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+  {
+    if (i->client && i->stats.active)
+    {
+      qint64 dueNS = (i->lastNS + static_cast<qint64>(i->stats.intervalMS) * 1000000);
+      if (!hasNext || dueNS < nextNS)
+      {
+        nextNS = dueNS;
+        hasNext = true;
+      }
+    }
+  }
+
+  if (hasNext)
+  {
+    qint64 nowNS = m_Clock.nsecsElapsed();
+    int ms = ((nextNS > nowNS) ? static_cast<int>((nextNS - nowNS + 999999) / 1000000) : 0);
+    if (!m_Timer->isActive() || m_Timer->remainingTime() > ms)
+      m_Timer->start(ms);
+  }
+  else
+    m_Timer->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::Schedule(const sSubscriber &subscriber)
+{
+  // only this subscriber changed, so it can only bring the next timeout forward
+  if (m_Ticking || !subscriber.client || !subscriber.stats.active)
+    return;
+
+  qint64 dueNS = (subscriber.lastNS + static_cast<qint64>(subscriber.stats.intervalMS) * 1000000);
+  qint64 nowNS = m_Clock.nsecsElapsed();
+  int ms = ((dueNS > nowNS) ? static_cast<int>((dueNS - nowNS + 999999) / 1000000) : 0);
+  if (!m_Timer->isActive() || m_Timer->remainingTime() > ms)
+    m_Timer->start(ms);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::RemoveAt(size_t index)
+{
+  // order does not matter, so the last subscriber fills the gap
+  if ((index + 1) < m_List.size())
+  {
+    m_List[index] = m_List.back();
+    if (m_List[index].client)
+      m_Indicies[m_List[index].client] = index;
+  }
+
+  m_List.pop_back();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::RebuildIndicies()
+{
+  m_Indicies.clear();
+  for (size_t i = 0; i < m_List.size(); i++)
+  {
+    if (m_List[i].client)
+      m_Indicies.insert(m_List[i].client, i);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::onTimeout()
+{
+  m_Ticking = true;
+  m_Wakeups++;
+
+  qint64 nowNS = m_Clock.nsecsElapsed();
+
+  // index based, clients may subscribe during their tick
+  for (size_t i = 0; i < m_List.size(); i++)
+  {
+    sSubscriber &subscriber = m_List[i];
+    if (subscriber.client && subscriber.stats.active)
+    {
+      qint64 elapsedNS = (nowNS - subscriber.lastNS);
+      if ((elapsedNS + TICK_SLACK_NS) >= (static_cast<qint64>(subscriber.stats.intervalMS) * 1000000))
+      {
+        unsigned int ms = static_cast<unsigned int>(elapsedNS / 1000000);
+        if (ms != 0)
+        {
+          // keep the sub-millisecond remainder for the next tick
+          subscriber.lastNS += (static_cast<qint64>(ms) * 1000000);
+
+          qint64 startNS = m_Clock.nsecsElapsed();
+          subscriber.client->FrameSchedulerClient_Tick(ms);
+          qint64 costNS = (m_Clock.nsecsElapsed() - startNS);
+
+          sStats &stats = m_List[i].stats;
+          stats.ticks++;
+          stats.costNS += costNS;
+          if (costNS > stats.maxCostNS)
+            stats.maxCostNS = costNS;
+        }
+      }
+    }
+  }
+
+  m_Ticking = false;
+
+  if (m_Dirty)
+  {
+    for (SUBSCRIBERS::iterator i = m_List.begin(); i != m_List.end();)
+    {
+      if (i->client)
+        i++;
+      else
+        i = m_List.erase(i);
+    }
+
+    RebuildIndicies();
+    m_Dirty = false;
+  }
+
+  Schedule();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::Instantiate()
+{
+  if (!sm_Instance)
+    sm_Instance = new FrameScheduler();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameScheduler::Shutdown()
+{
+  if (sm_Instance)
+  {
+    delete sm_Instance;
+    sm_Instance = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
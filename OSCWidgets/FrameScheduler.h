@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#ifndef QT_INCLUDE_H
+#include "QtInclude.h"
+#endif
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Single monotonic clock and timer that drives all generator updates and fade
+// animations. Each client ticks at its own interval and the timer is stopped
+// entirely while no client is active.
+class FrameScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  class FrameSchedulerClient
+  {
+  public:
+    virtual void FrameSchedulerClient_Tick(unsigned int ms) = 0;
+  };
+
+  struct sStats
+  {
+    sStats()
+      : intervalMS(0)
+      , active(false)
+      , ticks(0)
+      , costNS(0)
+      , maxCostNS(0)
+    {
+    }
+
+    QString name;
+    unsigned int intervalMS;
+    bool active;
+    unsigned int ticks;
+    qint64 costNS;
+    qint64 maxCostNS;
+  };
+
+  typedef std::vector<sStats> STATS;
+
+  FrameScheduler();
+  virtual ~FrameScheduler();
+
+  virtual void Subscribe(FrameSchedulerClient &client, const QString &name, unsigned int intervalMS, bool active);
+  virtual void Unsubscribe(FrameSchedulerClient &client);
+  virtual void SetInterval(FrameSchedulerClient &client, unsigned int intervalMS);
+  virtual void SetActive(FrameSchedulerClient &client, bool b);
+  virtual bool IsActive(FrameSchedulerClient &client) const;
+  virtual qint64 GetElapsedNS() const { return m_Clock.nsecsElapsed(); }
+  virtual qint64 GetStatsElapsedNS() const { return (m_Clock.nsecsElapsed() - m_StatsStartNS); }
+  virtual void GetStats(STATS &stats) const;
+  virtual unsigned int GetWakeups() const { return m_Wakeups; }
+  virtual void ResetStats();
+
+  static void Instantiate();
+  static void Shutdown();
+  static FrameScheduler &Instance() { return *sm_Instance; }
+
+private slots:
+  void onTimeout();
+
+protected:
+  enum EnumConstants
+  {
+    TICK_SLACK_NS = 500000
+  };
+
+  struct sSubscriber
+  {
+    sSubscriber()
+      : client(0)
+      , lastNS(0)
+    {
+    }
+
+    FrameSchedulerClient *client;
+    qint64 lastNS;
+    sStats stats;
+  };
+
+  typedef std::vector<sSubscriber> SUBSCRIBERS;
+  typedef QHash<FrameSchedulerClient *, size_t> SUBSCRIBER_INDICIES;
+
+  QTimer *m_Timer;
+  QElapsedTimer m_Clock;
+  SUBSCRIBERS m_List;
+  SUBSCRIBER_INDICIES m_Indicies;
+  size_t m_ActiveCount;
+  bool m_Ticking;
+  bool m_Dirty;
+  qint64 m_StatsStartNS;
+  unsigned int m_Wakeups;
+
+  virtual sSubscriber *Find(FrameSchedulerClient &client);
+  virtual const sSubscriber *Find(FrameSchedulerClient &client) const;
+  virtual void Schedule();
+  virtual void Schedule(const sSubscriber &subscriber);
+  virtual void RemoveAt(size_t index);
+  virtual void RebuildIndicies();
+
+  static FrameScheduler *sm_Instance;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define FS FrameScheduler::Instance()
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,972 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "GeneratorThread.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+GeneratorThread *GeneratorThread::sm_Instance = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::sSineBatch::Rebuild(GENERATORS &list)
+{
+  generators.clear();
+  anchorNS.clear();
+  anchorPhase.clear();
+  speed.clear();
+  lookaheadNS.clear();
+  min.clear();
+  max.clear();
+  phaseOffset.clear();
+  running.clear();
+  shaped.clear();
+
+  for (GENERATORS::iterator i = list.begin(); i != list.end(); i++)
+  {
+    sGenerator &generator = i->second;
+    if (generator.type != GENERATOR_SINE)
+      continue;
+
+    generator.sineIndex = generators.size();
+    generators.push_back(&generator);
+    anchorNS.push_back(generator.anchorNS);
+    anchorPhase.push_back(generator.anchorPhase);
+    speed.push_back(generator.speed);
+    lookaheadNS.push_back(generator.lookaheadNS);
+    min.push_back(generator.output.min);
+    max.push_back(generator.output.max);
+    phaseOffset.push_back(generator.phaseOffset);
+    running.push_back(generator.paused ? 0 : 1);
+
+    // anything but a plain sine goes through the general lookup afterwards
+    if (generator.waveform != Wavetable::WAVEFORM_SINE || generator.duty != 0.5f)
+      shaped.push_back(generator.sineIndex);
+  }
+
+  size_t count = generators.size();
+  due.assign(count, 0);
+  phase.resize(count);
+  value.resize(count);
+  outputValue.resize(count);
+  dirty = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GeneratorThread::GeneratorThread()
+  : m_pClient(0)
+  , m_Run(false)
+  , m_NextId(INVALID_ID)
+  , m_Wakeups(0)
+{
+  m_Clock.start();
+  m_UnixOffsetNS = (QDateTime::currentMSecsSinceEpoch() * 1000000 - m_Clock.nsecsElapsed());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GeneratorThread::~GeneratorThread()
+{
+  Stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Start()
+{
+  Stop();
+
+  m_Run = true;
+  start(QThread::TimeCriticalPriority);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Stop()
+{
+  m_Mutex.lock();
+  m_Run = false;
+  m_Wake.wakeAll();
+  m_Mutex.unlock();
+
+  wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetClient(GeneratorClient *pClient)
+{
+  // blocks until any send in progress has completed
+  QMutexLocker locker(&m_Mutex);
+  m_pClient = pClient;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GeneratorThread::ID GeneratorThread::Add(EnumGeneratorType type, unsigned int intervalMS)
+{
+  QMutexLocker locker(&m_Mutex);
+
+  ID id = ++m_NextId;
+  if (id == INVALID_ID)
+    id = ++m_NextId;
+
+  sGenerator &generator = m_Generators[id];
+  generator.type = type;
+  generator.intervalMS = qMax(1u, intervalMS);
+  generator.lastNS = generator.anchorNS = GetClockNS();
+  generator.random.Seed(QRandomGenerator::global()->generate());
+  UpdateSpeed(generator);
+  UpdateMsPerBeat(generator);
+  m_SineBatch.dirty = true;
+  return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Remove(ID id)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    QString clock(i->second.clock);
+    m_Generators.erase(i);
+    m_SineBatch.dirty = true;
+    RemoveUnusedClock(clock);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetInterval(ID id, unsigned int intervalMS)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    i->second.intervalMS = qMax(1u, intervalMS);
+    m_Wake.wakeAll();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetPaused(ID id, bool b)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    sGenerator &generator = i->second;
+    if (!generator.clock.isEmpty())
+    {
+      // pausing one member pauses the whole group
+      CLOCKS::iterator c = m_Clocks.find(generator.clock);
+      if (c != m_Clocks.end())
+        UpdateClockPaused(c->first, c->second, b, GetClockNS());
+    }
+    else if (generator.paused != b)
+    {
+      qint64 nowNS = GetClockNS();
+      Rebase(generator, nowNS);
+      generator.paused = b;
+      generator.state.paused = b;
+      generator.elapsed = 0;
+      generator.lastNS = nowNS;
+      m_Wake.wakeAll();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetBPM(ID id, float bpm)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end() && !i->second.clock.isEmpty())
+  {
+    CLOCKS::iterator c = m_Clocks.find(i->second.clock);
+    if (c != m_Clocks.end())
+      UpdateClockBPM(c->first, c->second, bpm, GetClockNS());
+  }
+  else if (i != m_Generators.end() && i->second.bpm != bpm)
+  {
+    Rebase(i->second, GetClockNS());
+    i->second.bpm = bpm;
+    UpdateSpeed(i->second);
+    UpdateMsPerBeat(i->second);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetPos(ID id, float pos)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    sGenerator &generator = i->second;
+    qint64 nowNS = GetClockNS();
+    CLOCKS::const_iterator c = (generator.clock.isEmpty() ? m_Clocks.end() : m_Clocks.find(generator.clock));
+    if (c != m_Clocks.end())
+    {
+      // members keep following the clock, just offset from it
+      generator.clockOffset = WrapPhase(pos - GetClockPhase(c->second, nowNS));
+      SyncToClock(generator, c->second, nowNS);
+      generator.segment = GetMetroSegmentIndex(GetGeneratorPhase(generator, nowNS));
+    }
+    else
+      SetAnchor(generator, nowNS, pos);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetTimeScaleRange(ID id, float minTimeScale, float maxTimeScale)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    sGenerator &generator = i->second;
+    if (generator.minTimeScale != minTimeScale || generator.maxTimeScale != maxTimeScale)
+    {
+      generator.minTimeScale = minTimeScale;
+      generator.maxTimeScale = maxTimeScale;
+      UpdateMsPerBeat(generator);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetWaveform(ID id, Wavetable::EnumWaveform waveform, float phaseOffset, float duty)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    i->second.waveform = waveform;
+    i->second.phaseOffset = phaseOffset;
+    i->second.duty = duty;
+    m_SineBatch.dirty = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetSeed(ID id, quint32 seed)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+    Seed(i->second, seed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetLookahead(ID id, unsigned int lookaheadMS)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    i->second.lookaheadNS = (static_cast<qint64>(lookaheadMS) * 1000000);
+    m_SineBatch.dirty = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetClock(ID id, const QString &name)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i == m_Generators.end() || i->second.clock == name)
+    return;
+
+  sGenerator &generator = i->second;
+  qint64 nowNS = GetClockNS();
+  QString prevClock(generator.clock);
+  generator.clock = name;
+  RemoveUnusedClock(prevClock);
+
+  if (name.isEmpty())
+  {
+    // free running again, from wherever the group left it
+    Rebase(generator, nowNS);
+    return;
+  }
+
+  CLOCKS::iterator c = m_Clocks.find(name);
+  if (c == m_Clocks.end())
+  {
+    // the first member defines the clock
+    sClock &clock = m_Clocks[name];
+    clock.anchorNS = nowNS;
+    clock.anchorPhase = WrapPhase(GetGeneratorPhase(generator, nowNS));
+    clock.paused = generator.paused;
+    clock.bpm = generator.bpm;
+    clock.speed = generator.speed;
+    c = m_Clocks.find(name);
+  }
+
+  generator.clockOffset = 0;
+  SyncToClock(generator, c->second, nowNS);
+  generator.segment = GetMetroSegmentIndex(GetGeneratorPhase(generator, nowNS));
+  m_Wake.wakeAll();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetClockBPM(const QString &name, float bpm)
+{
+  QMutexLocker locker(&m_Mutex);
+  CLOCKS::iterator c = m_Clocks.find(name);
+  if (c != m_Clocks.end())
+    UpdateClockBPM(c->first, c->second, bpm, GetClockNS());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetClockPaused(const QString &name, bool b)
+{
+  QMutexLocker locker(&m_Mutex);
+  CLOCKS::iterator c = m_Clocks.find(name);
+  if (c != m_Clocks.end())
+    UpdateClockPaused(c->first, c->second, b, GetClockNS());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::TapClock(const QString &name)
+{
+  QMutexLocker locker(&m_Mutex);
+
+  // clocks only exist while a generator follows them, so names arriving over OSC
+  // for anything else are ignored rather than creating one
+  CLOCKS::iterator c = m_Clocks.find(name);
+  if (c == m_Clocks.end())
+    return;
+
+  sClock &clock = c->second;
+  qint64 nowNS = GetClockNS();
+
+  if (clock.lastTapNS >= 0 && (nowNS - clock.lastTapNS) < (static_cast<qint64>(TAP_TIMEOUT_MS) * 1000000))
+  {
+    if (clock.tapCount == TAP_COUNT)
+    {
+      for (int i = 1; i < TAP_COUNT; i++)
+        clock.tapIntervalNS[i - 1] = clock.tapIntervalNS[i];
+      --clock.tapCount;
+    }
+
+    clock.tapIntervalNS[clock.tapCount++] = (nowNS - clock.lastTapNS);
+
+    qint64 totalNS = 0;
+    for (int i = 0; i < clock.tapCount; i++)
+      totalNS += clock.tapIntervalNS[i];
+
+    float bpm = static_cast<float>(60000000000.0 * clock.tapCount / totalNS);
+    UpdateClockBPM(name, clock, qBound(1.0f, bpm, 600.0f), nowNS);
+
+    // the tap lands on a beat, one beat is half a cycle
+    RebaseClock(clock, nowNS);
+    clock.anchorPhase = WrapPhase(floor(clock.anchorPhase / M_PI + 0.5) * M_PI);
+    ApplyClock(name, clock, nowNS);
+  }
+  else
+    clock.tapCount = 0;
+
+  clock.lastTapNS = nowNS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetOutput(ID id, const sOutput &output)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    i->second.output = output;
+    i->second.sent = false;
+    m_SineBatch.dirty = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Trigger(ID id, EnumMetroTick tick)
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::const_iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+    SendTick(i->second.output, tick, GetClockNS());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool GeneratorThread::GetState(ID id, sState &state) const
+{
+  QMutexLocker locker(&m_Mutex);
+  GENERATORS::const_iterator i = m_Generators.find(id);
+  if (i != m_Generators.end())
+  {
+    state = i->second.state;
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int GeneratorThread::TakeWakeups()
+{
+  QMutexLocker locker(&m_Mutex);
+  unsigned int wakeups = m_Wakeups;
+  m_Wakeups = 0;
+  return wakeups;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int GeneratorThread::GetMsPerBeat(float bpm, float timeScale)
+{
+  float scaledBMP = (bpm * timeScale);
+
+  unsigned int msPerBeat = ((scaledBMP > 0) ? (60000.0f / scaledBMP) : 0);
+
+  if (bpm > 0 && msPerBeat == 0)
+    msPerBeat = 1;
+
+  return msPerBeat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int GeneratorThread::GetMetroSegment(float pos)
+{
+  return static_cast<int>(pos / TWO_PI * 3.99999);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 GeneratorThread::GetMetroSegmentIndex(double phase)
+{
+  return static_cast<qint64>(floor(phase * METRO_SEGMENT_COUNT / TWO_PI));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GeneratorThread::GetMetroSegmentPhase(qint64 segment)
+{
+  return (segment * TWO_PI / METRO_SEGMENT_COUNT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GeneratorThread::GetPhase(double anchorPhase, double speed, qint64 elapsedNS)
+{
+  // always measured from the anchor, so rounding never accumulates tick over tick
+  return (anchorPhase + speed * static_cast<double>(elapsedNS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 GeneratorThread::GetPhaseTimeNS(qint64 anchorNS, double anchorPhase, double speed, double phase)
+{
+  // inverse of GetPhase, for stamping events with when they are due
+  if (speed <= 0)
+    return anchorNS;
+
+  return (anchorNS + static_cast<qint64>((phase - anchorPhase) / speed));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+quint64 GeneratorThread::GetTimeTag(qint64 unixNS)
+{
+  // NTP time: seconds since 1900 in the high word, fraction of a second in the low word
+  quint64 seconds = (static_cast<quint64>(unixNS / 1000000000) + 2208988800ULL);
+  quint64 fraction = ((static_cast<quint64>(unixNS % 1000000000) << 32) / 1000000000);
+  return ((seconds << 32) | fraction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+GeneratorThread::EnumMetroTick GeneratorThread::GetMetroTickForSegment(int segment)
+{
+  switch (segment)
+  {
+    case 1: return METRO_TICK_RIGHT;
+    case 3: return METRO_TICK_LEFT;
+  }
+
+  return METRO_TICK_CENTER;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::UpdateSpeed(sGenerator &generator)
+{
+  double beatsPerNanosecond = (generator.bpm / 60000000000.0);
+  generator.speed = (beatsPerNanosecond * M_PI);
+  m_SineBatch.dirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SetAnchor(sGenerator &generator, qint64 nowNS, double phase)
+{
+  phase = WrapPhase(phase);
+
+  generator.anchorNS = nowNS;
+  generator.anchorPhase = phase;
+  generator.segment = GetMetroSegmentIndex(phase);
+  generator.state.pos = static_cast<float>(phase);
+  m_SineBatch.dirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Rebase(sGenerator &generator, qint64 nowNS)
+{
+  // re-anchor at the current phase before anything that changes its rate
+  double phase = GetGeneratorPhase(generator, nowNS);
+
+  // ticks already scheduled ahead of now must not be sent again from the new anchor
+  qint64 scheduled = (generator.segment - GetMetroSegmentIndex(phase));
+  SetAnchor(generator, nowNS, phase);
+  if (scheduled > 0)
+    generator.segment += scheduled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::UpdateMsPerBeat(sGenerator &generator)
+{
+  float timeScale = 1.0f;
+
+  if (generator.minTimeScale > 0 && generator.maxTimeScale > 0)
+  {
+    float t = generator.random.NextFloat();
+    timeScale = (generator.minTimeScale * t + generator.maxTimeScale * (1.0f - t));
+  }
+
+  generator.msPerBeat = GetMsPerBeat(generator.bpm, timeScale);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::RemoveUnusedClock(const QString &name)
+{
+  if (name.isEmpty())
+    return;
+
+  for (GENERATORS::const_iterator i = m_Generators.begin(); i != m_Generators.end(); i++)
+  {
+    if (i->second.clock == name)
+      return;
+  }
+
+  m_Clocks.erase(name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::RebaseClock(sClock &clock, qint64 nowNS)
+{
+  clock.anchorPhase = WrapPhase(GetClockPhase(clock, nowNS));
+  clock.anchorNS = nowNS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::UpdateClockBPM(const QString &name, sClock &clock, float bpm, qint64 nowNS)
+{
+  if (clock.bpm != bpm)
+  {
+    RebaseClock(clock, nowNS);
+    clock.bpm = bpm;
+    clock.speed = ((bpm / 60000000000.0) * M_PI);
+    ApplyClock(name, clock, nowNS);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::UpdateClockPaused(const QString &name, sClock &clock, bool b, qint64 nowNS)
+{
+  if (clock.paused != b)
+  {
+    RebaseClock(clock, nowNS);
+    clock.paused = b;
+    ApplyClock(name, clock, nowNS);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::ApplyClock(const QString &name, const sClock &clock, qint64 nowNS)
+{
+  for (GENERATORS::iterator i = m_Generators.begin(); i != m_Generators.end(); i++)
+  {
+    if (i->second.clock == name)
+      SyncToClock(i->second, clock, nowNS);
+  }
+
+  m_Wake.wakeAll();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SyncToClock(sGenerator &generator, const sClock &clock, qint64 nowNS)
+{
+  // ticks already scheduled ahead of now must not be sent again from the new anchor
+  qint64 scheduled = (generator.segment - GetMetroSegmentIndex(GetGeneratorPhase(generator, nowNS)));
+
+  generator.anchorNS = clock.anchorNS;
+  generator.anchorPhase = (clock.anchorPhase + generator.clockOffset);
+  generator.speed = clock.speed;
+
+  if (generator.paused != clock.paused)
+  {
+    generator.paused = clock.paused;
+    generator.state.paused = clock.paused;
+    generator.elapsed = 0;
+    generator.lastNS = nowNS;
+  }
+
+  if (generator.bpm != clock.bpm)
+  {
+    generator.bpm = clock.bpm;
+    UpdateMsPerBeat(generator);
+  }
+
+  double phase = GetGeneratorPhase(generator, nowNS);
+  generator.segment = (GetMetroSegmentIndex(phase) + qMax(static_cast<qint64>(0), scheduled));
+  generator.state.pos = static_cast<float>(fmod(phase, TWO_PI));
+  m_SineBatch.dirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GeneratorThread::GetGeneratorPhase(const sGenerator &generator, qint64 nowNS)
+{
+  return (generator.paused ? generator.anchorPhase : GetPhase(generator.anchorPhase, generator.speed, nowNS - generator.anchorNS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GeneratorThread::GetClockPhase(const sClock &clock, qint64 nowNS)
+{
+  return (clock.paused ? clock.anchorPhase : GetPhase(clock.anchorPhase, clock.speed, nowNS - clock.anchorNS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double GeneratorThread::WrapPhase(double phase)
+{
+  phase = fmod(phase, TWO_PI);
+  if (phase < 0)
+    phase += TWO_PI;
+  return phase;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Seed(sGenerator &generator, quint32 seed)
+{
+  // restart the whole random sequence, including the first beat length
+  generator.random.Seed(seed);
+  generator.elapsed = 0;
+  UpdateMsPerBeat(generator);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Update(sGenerator &generator, qint64 nowNS, unsigned int ms)
+{
+  switch (generator.type)
+  {
+    case GENERATOR_SINE: break; // evaluated in batches by UpdateSines
+
+    case GENERATOR_METRO:
+    {
+      double phase = GetPhase(generator.anchorPhase, generator.speed, nowNS - generator.anchorNS);
+      generator.state.pos = static_cast<float>(fmod(phase, TWO_PI));
+
+      // tick for every segment crossed since the last update, however late this update is;
+      // the count is bounded by the elapsed time, a stall only makes the ticks arrive together
+      double aheadPhase = GetPhase(generator.anchorPhase, generator.speed, nowNS + generator.lookaheadNS - generator.anchorNS);
+      qint64 segment = GetMetroSegmentIndex(aheadPhase);
+      for (qint64 s = (generator.segment + 1); s <= segment; s++)
+      {
+        // stamp each tick with the moment the phase actually crosses into its segment
+        qint64 atNS = GetPhaseTimeNS(generator.anchorNS, generator.anchorPhase, generator.speed, GetMetroSegmentPhase(s));
+        SendTick(generator.output, GetMetroTickForSegment(static_cast<int>(s % METRO_SEGMENT_COUNT)), qMax(atNS, nowNS));
+      }
+      if (segment > generator.segment)
+        generator.segment = segment;
+    }
+    break;
+
+    case GENERATOR_FLICKER:
+    {
+      if (generator.msPerBeat != 0)
+      {
+        generator.elapsed += ms;
+
+        while (generator.msPerBeat != 0 && generator.elapsed >= generator.msPerBeat)
+        {
+          generator.elapsed -= generator.msPerBeat;
+          generator.state.value = generator.random.NextFloat();
+          Send(generator.output, generator.state.value);
+          if (generator.minTimeScale > 0 && generator.maxTimeScale > 0)
+            UpdateMsPerBeat(generator);
+        }
+      }
+    }
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::UpdateSines(sSineBatch &batch, qint64 nowNS)
+{
+  size_t count = batch.generators.size();
+  if (count == 0)
+    return;
+
+  // every sine is evaluated, due or not, so the loops have no calls or branches
+  const qint64 *anchorNS = &batch.anchorNS[0];
+  const double *anchorPhase = &batch.anchorPhase[0];
+  const double *speed = &batch.speed[0];
+  const qint64 *lookaheadNS = &batch.lookaheadNS[0];
+  const float *min = &batch.min[0];
+  const float *max = &batch.max[0];
+  const float *phaseOffset = &batch.phaseOffset[0];
+  const unsigned char *running = &batch.running[0];
+  double *phase = &batch.phase[0];
+  float *value = &batch.value[0];
+  float *outputValue = &batch.outputValue[0];
+
+  // with lookahead, evaluate where the output will be when the receiver plays it
+  for (size_t i = 0; i < count; i++)
+    phase[i] = (anchorPhase[i] + speed[i] * running[i] * static_cast<double>(nowNS + lookaheadNS[i] - anchorNS[i]));
+
+  for (size_t i = 0; i < count; i++)
+    value[i] = Wavetable::LookupSine(phase[i] / TWO_PI + phaseOffset[i]);
+
+  for (size_t i = 0; i < batch.shaped.size(); i++)
+  {
+    size_t index = batch.shaped[i];
+    const sGenerator &generator = *batch.generators[index];
+    value[index] = Wavetable::Lookup(generator.waveform, phase[index] / TWO_PI + phaseOffset[index], generator.duty);
+  }
+
+  for (size_t i = 0; i < count; i++)
+    outputValue[i] = (min[i] + (max[i] - min[i]) * value[i]);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!batch.due[i])
+      continue;
+
+    batch.due[i] = 0;
+    sGenerator &generator = *batch.generators[i];
+    generator.state.pos = static_cast<float>(fmod(phase[i], TWO_PI));
+    generator.state.value = value[i];
+
+    // only send when the output actually moved
+    if (!generator.sent || generator.sentValue != outputValue[i])
+    {
+      generator.sent = true;
+      generator.sentValue = outputValue[i];
+
+      size_t size;
+      char *packet = generator.output.packetTemplate.Create(&outputValue[i], generator.output.floatCount, size);
+      if (packet)
+        SendPacket(generator.output, packet, size, nowNS + lookaheadNS[i]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Send(const sOutput &output, float value)
+{
+  if (m_pClient && output.enabled)
+  {
+    value = (output.min + (output.max - output.min) * value);
+
+    size_t size;
+    char *packet = output.packetTemplate.Create(&value, output.floatCount, size);
+    if (packet)
+      SendPacket(output, packet, size, /*atNS*/ 0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SendTick(const sOutput &output, EnumMetroTick tick, qint64 atNS)
+{
+  if (m_pClient && output.enabled && tick >= 0 && tick < METRO_TICK_COUNT)
+  {
+    const QByteArray &ba = output.tickPackets[tick];
+    if (!ba.isEmpty())
+    {
+      size_t size = static_cast<size_t>(ba.size());
+      char *packet = new char[size];
+      memcpy(packet, ba.constData(), size);
+      SendPacket(output, packet, size, atNS);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::SendPacket(const sOutput &output, char *data, size_t size, qint64 atNS)
+{
+  if (!m_pClient || !output.enabled)
+  {
+    delete[] data;
+    return;
+  }
+
+  // events computed ahead of time go out in a bundle so the receiver can play them on time,
+  // local delivery has no receiver clock so it is sent as is
+  if (output.local || atNS <= GetClockNS())
+  {
+    m_pClient->GeneratorClient_Send(output.local, data, size);
+    return;
+  }
+
+  size_t bundleSize = (BUNDLE_HEADER_SIZE + 4 + size);
+  char *bundle = new char[bundleSize];
+  memcpy(bundle, "#bundle", 8);
+
+  quint64 timeTag = GetTimeTag(m_UnixOffsetNS + atNS);
+  qToBigEndian(timeTag, bundle + 8);
+  qToBigEndian(static_cast<quint32>(size), bundle + BUNDLE_HEADER_SIZE);
+  memcpy(bundle + BUNDLE_HEADER_SIZE + 4, data, size);
+  delete[] data;
+
+  m_pClient->GeneratorClient_Send(/*local*/ false, bundle, bundleSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool GeneratorThread::Process(qint64 nowNS, qint64 &nextNS)
+{
+  bool hasNext = false;
+  nextNS = 0;
+  if (m_SineBatch.dirty)
+    m_SineBatch.Rebuild(m_Generators);
+
+  for (GENERATORS::iterator i = m_Generators.begin(); i != m_Generators.end(); i++)
+  {
+    sGenerator &generator = i->second;
+    if (generator.paused)
+      continue;
+
+    qint64 intervalNS = (static_cast<qint64>(generator.intervalMS) * 1000000);
+    qint64 elapsedNS = (nowNS - generator.lastNS);
+    if (elapsedNS >= intervalNS)
+    {
+      // keep the sub-millisecond remainder for the next update
+      unsigned int ms = static_cast<unsigned int>(elapsedNS / 1000000);
+      generator.lastNS += (static_cast<qint64>(ms) * 1000000);
+      if (generator.type == GENERATOR_SINE)
+        m_SineBatch.due[generator.sineIndex] = 1;
+      else
+        Update(generator, nowNS, ms);
+    }
+
+    qint64 dueNS = (generator.lastNS + intervalNS);
+    if (!hasNext || dueNS < nextNS)
+    {
+      nextNS = dueNS;
+      hasNext = true;
+    }
+  }
+
+  UpdateSines(m_SineBatch, nowNS);
+  return hasNext;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::run()
+{
+  m_Mutex.lock();
+
+  while (m_Run)
+  {
+    m_Wakeups++;
+
+    qint64 nextNS = 0;
+    if (Process(GetClockNS(), nextNS))
+    {
+      qint64 waitNS = (nextNS - GetClockNS());
+      if (waitNS > 0)
+      {
+        QDeadlineTimer deadline(Qt::PreciseTimer);
+        deadline.setPreciseRemainingTime(0, waitNS, Qt::PreciseTimer);
+        m_Wake.wait(&m_Mutex, deadline);
+      }
+    }
+    else
+      m_Wake.wait(&m_Mutex);  // nothing running, sleep until something changes
+  }
+
+  m_Mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Instantiate()
+{
+  if (!sm_Instance)
+  {
+    sm_Instance = new GeneratorThread();
+    sm_Instance->Start();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GeneratorThread::Shutdown()
+{
+  if (sm_Instance)
+  {
+    delete sm_Instance;
+    sm_Instance = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
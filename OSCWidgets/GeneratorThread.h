@@ -0,0 +1,317 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef GENERATOR_THREAD_H
+#define GENERATOR_THREAD_H
+
+#ifndef QT_INCLUDE_H
+#include "QtInclude.h"
+#endif
+
+#ifndef UTILS_H
+#include "Utils.h"
+#endif
+
+#ifndef TOY_MATH_H
+#include "ToyMath.h"
+#endif
+
+#ifndef WAVETABLE_H
+#include "Wavetable.h"
+#endif
+
+#include <map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Runs sine, metronome and flicker generators off the GUI thread and sends their
+// output directly, so GUI stalls do not disturb timing. Widgets only read back
+// the latest state for drawing.
+class GeneratorThread : private QThread
+{
+public:
+  class GeneratorClient
+  {
+  public:
+    // called from the generator thread
+    virtual void GeneratorClient_Send(bool local, char *data, size_t size) = 0;
+  };
+
+  enum EnumGeneratorType
+  {
+    GENERATOR_SINE,
+    GENERATOR_METRO,
+    GENERATOR_FLICKER
+  };
+
+  enum EnumMetroTick
+  {
+    METRO_TICK_LEFT,
+    METRO_TICK_CENTER,
+    METRO_TICK_RIGHT,
+
+    METRO_TICK_COUNT
+  };
+
+  typedef unsigned int ID;
+
+  enum EnumConstants
+  {
+    INVALID_ID = 0,
+    METRO_SEGMENT_COUNT = 4,
+    BUNDLE_HEADER_SIZE = 16,
+    TAP_COUNT = 4,
+    TAP_TIMEOUT_MS = 2000
+  };
+
+  // prepared on the GUI thread whenever a path or min/max changes
+  struct sOutput
+  {
+    sOutput()
+      : enabled(false)
+      , local(false)
+      , floatCount(0)
+      , min(0)
+      , max(0)
+    {
+    }
+
+    bool enabled;
+    bool local;
+    OSCPacketTemplate packetTemplate;
+    size_t floatCount;
+    float min;
+    float max;
+    QByteArray tickPackets[METRO_TICK_COUNT];
+  };
+
+  struct sState
+  {
+    sState()
+      : paused(true)
+      , pos(0)
+      , value(0)
+    {
+    }
+
+    bool paused;
+    float pos;
+    float value;
+  };
+
+  GeneratorThread();
+  virtual ~GeneratorThread();
+
+  virtual void Start();
+  virtual void Stop();
+  virtual void SetClient(GeneratorClient *pClient);
+  virtual ID Add(EnumGeneratorType type, unsigned int intervalMS);
+  virtual void Remove(ID id);
+  virtual void SetInterval(ID id, unsigned int intervalMS);
+  virtual void SetPaused(ID id, bool b);
+  virtual void SetBPM(ID id, float bpm);
+  virtual void SetPos(ID id, float pos);
+  virtual void SetTimeScaleRange(ID id, float minTimeScale, float maxTimeScale);
+  virtual void SetWaveform(ID id, Wavetable::EnumWaveform waveform, float phaseOffset, float duty);
+  virtual void SetSeed(ID id, quint32 seed);
+  virtual void SetLookahead(ID id, unsigned int lookaheadMS);
+  virtual void SetClock(ID id, const QString &name);
+  virtual void SetClockBPM(const QString &name, float bpm);
+  virtual void SetClockPaused(const QString &name, bool b);
+  virtual void TapClock(const QString &name);
+  virtual void SetOutput(ID id, const sOutput &output);
+  virtual void Trigger(ID id, EnumMetroTick tick);
+  virtual bool GetState(ID id, sState &state) const;
+  virtual unsigned int TakeWakeups();
+
+  static unsigned int GetMsPerBeat(float bpm, float timeScale);
+  static int GetMetroSegment(float pos);
+  static qint64 GetMetroSegmentIndex(double phase);
+  static double GetMetroSegmentPhase(qint64 segment);
+  static double GetPhase(double anchorPhase, double speed, qint64 elapsedNS);
+  static qint64 GetPhaseTimeNS(qint64 anchorNS, double anchorPhase, double speed, double phase);
+  static quint64 GetTimeTag(qint64 unixNS);
+  static EnumMetroTick GetMetroTickForSegment(int segment);
+
+  static void Instantiate();
+  static void Shutdown();
+  static GeneratorThread &Instance() { return *sm_Instance; }
+
+protected:
+  struct sGenerator
+  {
+    sGenerator()
+      : type(GENERATOR_SINE)
+      , intervalMS(1)
+      , lastNS(0)
+      , anchorNS(0)
+      , anchorPhase(0)
+      , segment(0)
+      , paused(true)
+      , bpm(0)
+      , speed(0)
+      , minTimeScale(0)
+      , maxTimeScale(0)
+      , msPerBeat(0)
+      , elapsed(0)
+      , lookaheadNS(0)
+      , waveform(Wavetable::WAVEFORM_SINE)
+      , phaseOffset(0)
+      , duty(0.5f)
+      , sent(false)
+      , sentValue(0)
+      , clockOffset(0)
+      , sineIndex(0)
+    {
+    }
+
+    EnumGeneratorType type;
+    unsigned int intervalMS;
+    qint64 lastNS;
+    qint64 anchorNS;
+    double anchorPhase;
+    qint64 segment;
+    bool paused;
+    float bpm;
+    double speed;
+    float minTimeScale;
+    float maxTimeScale;
+    unsigned int msPerBeat;
+    unsigned int elapsed;
+    qint64 lookaheadNS;
+    Wavetable::EnumWaveform waveform;
+    float phaseOffset;
+    float duty;
+    bool sent;
+    float sentValue;
+    QString clock;
+    double clockOffset;
+    size_t sineIndex;
+    FastRandom random;
+    sState state;
+    sOutput output;
+  };
+
+  typedef std::map<ID, sGenerator> GENERATORS;
+
+  // a named tempo shared by every generator following it; members copy its anchor,
+  // so the whole group evaluates the same phase
+  struct sClock
+  {
+    sClock()
+      : anchorNS(0)
+      , anchorPhase(0)
+      , paused(true)
+      , bpm(0)
+      , speed(0)
+      , lastTapNS(-1)
+      , tapCount(0)
+    {
+    }
+
+    qint64 anchorNS;
+    double anchorPhase;
+    bool paused;
+    float bpm;
+    double speed;
+    qint64 lastTapNS;
+    int tapCount;
+    qint64 tapIntervalNS[TAP_COUNT];
+  };
+
+  typedef std::map<QString, sClock> CLOCKS;
+
+  // every sine generator kept in flat arrays and evaluated together each pass;
+  // only rebuilt when a generator is added, removed or changed
+  struct sSineBatch
+  {
+    sSineBatch()
+      : dirty(true)
+    {
+    }
+
+    bool dirty;
+    std::vector<sGenerator*> generators;
+    std::vector<qint64> anchorNS;
+    std::vector<double> anchorPhase;
+    std::vector<double> speed;
+    std::vector<qint64> lookaheadNS;
+    std::vector<float> min;
+    std::vector<float> max;
+    std::vector<float> phaseOffset;
+    std::vector<unsigned char> running;
+    std::vector<unsigned char> due;
+    std::vector<size_t> shaped;
+    std::vector<double> phase;
+    std::vector<float> value;
+    std::vector<float> outputValue;
+
+    void Rebuild(GENERATORS &list);
+  };
+
+  GeneratorClient *m_pClient;
+  bool m_Run;
+  ID m_NextId;
+  GENERATORS m_Generators;
+  CLOCKS m_Clocks;
+  sSineBatch m_SineBatch;
+  mutable QMutex m_Mutex;
+  QWaitCondition m_Wake;
+  QElapsedTimer m_Clock;
+  qint64 m_UnixOffsetNS;
+  unsigned int m_Wakeups;
+
+  virtual void run();
+  // one pass over every running generator, false when none is running
+  virtual bool Process(qint64 nowNS, qint64 &nextNS);
+  virtual qint64 GetClockNS() const { return m_Clock.nsecsElapsed(); }
+  virtual void Update(sGenerator &generator, qint64 nowNS, unsigned int ms);
+  virtual void SetAnchor(sGenerator &generator, qint64 nowNS, double phase);
+  virtual void Rebase(sGenerator &generator, qint64 nowNS);
+  virtual void RemoveUnusedClock(const QString &name);
+  virtual void RebaseClock(sClock &clock, qint64 nowNS);
+  virtual void UpdateClockBPM(const QString &name, sClock &clock, float bpm, qint64 nowNS);
+  virtual void UpdateClockPaused(const QString &name, sClock &clock, bool b, qint64 nowNS);
+  virtual void ApplyClock(const QString &name, const sClock &clock, qint64 nowNS);
+  virtual void SyncToClock(sGenerator &generator, const sClock &clock, qint64 nowNS);
+  virtual void UpdateSines(sSineBatch &batch, qint64 nowNS);
+  virtual void Send(const sOutput &output, float value);
+  virtual void SendTick(const sOutput &output, EnumMetroTick tick, qint64 atNS);
+  virtual void SendPacket(const sOutput &output, char *data, size_t size, qint64 atNS);
+  virtual void UpdateSpeed(sGenerator &generator);
+  virtual void UpdateMsPerBeat(sGenerator &generator);
+
+  static void Seed(sGenerator &generator, quint32 seed);
+  static double GetGeneratorPhase(const sGenerator &generator, qint64 nowNS);
+  static double GetClockPhase(const sClock &clock, qint64 nowNS);
+  static double WrapPhase(double phase);
+
+  static GeneratorThread *sm_Instance;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define GEN GeneratorThread::Instance()
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
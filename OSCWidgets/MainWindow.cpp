@@ -22,6 +22,7 @@
 #include "SettingsPanel.h"
 #include "LogWidget.h"
 #include "Utils.h"
+#include "FrameScheduler.h"
 #include "EosPlatform.h"
 #include <time.h>
 
@@ -185,10 +186,17 @@ MainWindow::MainWindow(EosPlatform *platform, QWidget *parent /*=0*/, Qt::Window
   , m_UdpOutThread(0)
   , m_UdpInThread(0)
   , m_TcpClientThread(0)
+  , m_LocalHops(0)
+  , m_LocalLoopReported(false)
+  , m_LocalTimer(0)
+  , m_TickTimer(0)
+  , m_IdleTicks(0)
+  , m_TickWakeups(0)
   , m_ToyTreeToyIndex(0)
   , m_ToyTreeType(Toy::TOY_INVALID)
   , m_pPlatform(platform)
   , m_SystemIdleAllowed(true)
+  , m_ResourceWatcher(0)
 {
   Utils::BlockFakeMouseEvents(true);
 
@@ -276,20 +284,37 @@ MainWindow::MainWindow(EosPlatform *platform, QWidget *parent /*=0*/, Qt::Window
   if (m_OpacityMenu)
     m_OpacityMenu->SetOpacity(m_Toys->GetOpacity());
 
-  QTimer *timer = new QTimer(this);
-  connect(timer, SIGNAL(timeout()), this, SLOT(onTick()));
-  timer->start(100);
+  // polls the network threads, backing off while idle until they report something pending
+  m_TickTimer = new QTimer(this);
+  connect(m_TickTimer, SIGNAL(timeout()), this, SLOT(onTick()));
+  m_TickTimer->start(TICK_MS);
+
+  // local messages are delivered on the next pass of the event loop, never re-entrantly from the sender
+  m_LocalTimer = new QTimer(this);
+  m_LocalTimer->setSingleShot(true);
+  m_LocalTimer->setInterval(0);
+  connect(m_LocalTimer, SIGNAL(timeout()), this, SLOT(onLocalTimeout()));
+
+  // resolved resource paths are cached, so forget them when a watched folder changes
+  m_ResourceWatcher = new QFileSystemWatcher(this);
+  connect(m_ResourceWatcher, SIGNAL(directoryChanged(const QString &)), this, SLOT(onResourceDirChanged(const QString &)));
 
   PopulateToyTree();
   RestoreLastFile();
   UpdateWindowTitle();
+
+  GEN.SetClient(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 MainWindow::~MainWindow()
 {
+  // blocks until the generator thread is no longer sending through us
+  GEN.SetClient(0);
+
   Shutdown();
+  ClearLocalQ();
 
   if (m_Toys)
   {
@@ -351,6 +376,7 @@ QMenuBar *MainWindow::InitMenuBar(bool systemMenuBar)
   QMenu *logMenu = menuBar->addMenu("&Log");
   logMenu->addAction(QIcon(":/assets/images/MenuIconRefresh.svg"), tr("&Clear"), this, SLOT(onClearLogClicked()));
   logMenu->addAction(QIcon(":/assets/images/MenuIconLog.svg"), tr("&View"), this, SLOT(onOpenLogClicked()));
+  logMenu->addAction(tr("&Stats"), this, SLOT(onLogStatsClicked()));
 
   return (systemMenuBar ? 0 : menuBar);
 }
@@ -389,6 +415,8 @@ void MainWindow::FlushLogQ(EosLog::LOG_Q &logQ)
 
 void MainWindow::Shutdown()
 {
+  QMutexLocker locker(&m_NetMutex);
+
   if (m_TcpClientThread)
   {
     m_TcpClientThread->Stop();
@@ -437,6 +465,23 @@ void MainWindow::ClearRecvQ()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MainWindow::ClearLocalQ()
+{
+  for (LOCAL_PACKET_Q::const_iterator i = m_LocalQ.begin(); i != m_LocalQ.end(); i++)
+  {
+    if (i->packet.data)
+      delete[] i->packet.data;
+  }
+  m_LocalQ.clear();
+
+  QMutexLocker locker(&m_NetMutex);
+  for (PACKET_Q::const_iterator i = m_GeneratorLocalQ.begin(); i != m_GeneratorLocalQ.end(); i++)
+    delete[] i->data;
+  m_GeneratorLocalQ.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MainWindow::ClearNetEventQ()
 {
   m_NetEventQ.clear();
@@ -652,6 +697,8 @@ bool MainWindow::LoadSettings(QStringList &lines, int &index)
 
 void MainWindow::Start()
 {
+  QMutexLocker locker(&m_NetMutex);
+
   Shutdown();
 
   OSCStream::EnumFrameMode mode = m_SettingsPanel->GetMode();
@@ -664,17 +711,17 @@ void MainWindow::Start()
     case OSCStream::FRAME_MODE_1_0:
     case OSCStream::FRAME_MODE_1_1:
     {
-      m_TcpClientThread = new EosTcpClientThread();
+      m_TcpClientThread = new EosTcpClientThread(this);
       m_TcpClientThread->Start(ip, m_SettingsPanel->GetTcpPort(), mode);
     }
     break;
 
     default:
     {
-      m_UdpOutThread = new EosUdpOutThread();
+      m_UdpOutThread = new EosUdpOutThread(this);
       m_UdpOutThread->Start(ip, m_SettingsPanel->GetUdpOutputPort());
 
-      m_UdpInThread = new EosUdpInThread();
+      m_UdpInThread = new EosUdpInThread(this);
       m_UdpInThread->Start(QString("0.0.0.0"), m_SettingsPanel->GetUdpInputPort());
     }
     break;
@@ -685,17 +732,55 @@ void MainWindow::Start()
 
 void MainWindow::ProcessRecvQ()
 {
+  m_Toys->Recv(m_RecvQ);
+
   for (PACKET_Q::const_iterator i = m_RecvQ.begin(); i != m_RecvQ.end(); i++)
-  {
-    m_Toys->Recv(i->data, i->size);
     delete[] i->data;
-  }
 
   m_RecvQ.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MainWindow::onLocalTimeout()
+{
+  // anything sent locally while delivering this slice is queued for the next one
+  m_LocalRecvQ.swap(m_LocalQ);
+
+  for (LOCAL_PACKET_Q::iterator i = m_LocalRecvQ.begin(); i != m_LocalRecvQ.end(); i++)
+  {
+    m_LocalHops = i->hops;
+    if (i->packet.data)
+    {
+      m_Toys->Recv(i->packet.data, i->packet.size);
+      delete[] i->packet.data;
+    }
+    else
+      m_Toys->Recv(i->msg);
+  }
+
+  m_LocalHops = 0;
+  m_LocalRecvQ.clear();
+
+  if (m_LocalQ.empty())
+    m_LocalLoopReported = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::onGeneratorLocal()
+{
+  PACKET_Q q;
+  m_NetMutex.lock();
+  q.swap(m_GeneratorLocalQ);
+  m_NetMutex.unlock();
+
+  for (PACKET_Q::const_iterator i = q.begin(); i != q.end(); i++)
+    ToyClient_Send(/*local*/true, i->data, i->size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MainWindow::ProcessNetEventQ()
 {
   for (NETEVENT_Q::const_iterator i = m_NetEventQ.begin(); i != m_NetEventQ.end(); i++)
@@ -811,6 +896,11 @@ void MainWindow::LoadAdvancedSettings()
   Toy::SetMetroRefreshRateMS(m_Settings.value(SETTING_METRO_REFRESH_RATE, Toy::GetMetroRefreshRateMS()).toUInt());
   Toy::SetSineRefreshRateMS(m_Settings.value(SETTING_SINE_REFRESH_RATE, Toy::GetSineRefreshRateMS()).toUInt());
   Toy::SetPedalRefreshRateMS(m_Settings.value(SETTING_PEDAL_REFRESH_RATE, Toy::GetPedalRefreshRateMS()).toUInt());
+  Toy::SetFlickerRefreshRateMS(m_Settings.value(SETTING_FLICKER_REFRESH_RATE, Toy::GetFlickerRefreshRateMS()).toUInt());
+  Toy::SetMetroVisualRateMS(m_Settings.value(SETTING_METRO_VISUAL_RATE, Toy::GetMetroVisualRateMS()).toUInt());
+  Toy::SetSineVisualRateMS(m_Settings.value(SETTING_SINE_VISUAL_RATE, Toy::GetSineVisualRateMS()).toUInt());
+  Toy::SetFlickerVisualRateMS(m_Settings.value(SETTING_FLICKER_VISUAL_RATE, Toy::GetFlickerVisualRateMS()).toUInt());
+  PMC.SetBudgetMB(m_Settings.value(SETTING_IMAGE_CACHE_MB, PMC.GetBudgetMB()).toUInt());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -824,6 +914,11 @@ void MainWindow::SaveAdvancedSettings()
   m_Settings.setValue(SETTING_METRO_REFRESH_RATE, Toy::GetMetroRefreshRateMS());
   m_Settings.setValue(SETTING_SINE_REFRESH_RATE, Toy::GetSineRefreshRateMS());
   m_Settings.setValue(SETTING_PEDAL_REFRESH_RATE, Toy::GetPedalRefreshRateMS());
+  m_Settings.setValue(SETTING_FLICKER_REFRESH_RATE, Toy::GetFlickerRefreshRateMS());
+  m_Settings.setValue(SETTING_METRO_VISUAL_RATE, Toy::GetMetroVisualRateMS());
+  m_Settings.setValue(SETTING_SINE_VISUAL_RATE, Toy::GetSineVisualRateMS());
+  m_Settings.setValue(SETTING_FLICKER_VISUAL_RATE, Toy::GetFlickerVisualRateMS());
+  m_Settings.setValue(SETTING_IMAGE_CACHE_MB, PMC.GetBudgetMB());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -862,11 +957,17 @@ void MainWindow::PromptForUnsavedChanges(bool &abortPendingOperation)
 
 void MainWindow::onTick()
 {
+  m_TickWakeups++;
+  m_NetPending.storeRelease(0);
+
+  bool busy = false;
+
   if (m_UdpOutThread)
   {
     ClearRecvQ();
     ClearNetEventQ();
     m_UdpOutThread->Flush(m_TempLogQ, m_NetEventQ);
+    busy |= !m_NetEventQ.empty();
     m_Log.AddQ(m_TempLogQ);
     ProcessNetEventQ();
     ProcessRecvQ();
@@ -876,6 +977,7 @@ void MainWindow::onTick()
   {
     ClearRecvQ();
     m_UdpInThread->Flush(m_TempLogQ, m_RecvQ);
+    busy |= !m_RecvQ.empty();
     m_Log.AddQ(m_TempLogQ);
     ProcessRecvQ();
   }
@@ -885,17 +987,49 @@ void MainWindow::onTick()
     ClearRecvQ();
     ClearNetEventQ();
     m_TcpClientThread->Flush(m_TempLogQ, m_RecvQ, m_NetEventQ);
+    busy |= (!m_RecvQ.empty() || !m_NetEventQ.empty());
     m_Log.AddQ(m_TempLogQ);
     ProcessNetEventQ();
     ProcessRecvQ();
   }
 
   m_Log.Flush(m_TempLogQ);
+  busy |= !m_TempLogQ.empty();
   FlushLogQ(m_TempLogQ);
   m_TempLogQ.clear();
 
   ClearRecvQ();
   ClearNetEventQ();
+
+  if (busy)
+    m_IdleTicks = 0;
+  else if (m_IdleTicks < IDLE_TICKS)
+    m_IdleTicks++;
+
+  int intervalMS = ((m_IdleTicks < IDLE_TICKS) ? TICK_MS : IDLE_TICK_MS);
+  if (m_TickTimer->interval() != intervalMS)
+    m_TickTimer->start(intervalMS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::onNetPending()
+{
+  if (m_IdleTicks < IDLE_TICKS)
+    return;  // already polling at full rate
+
+  // deliver straight away rather than waiting out the idle interval
+  onTick();
+  WakeTick();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::WakeTick()
+{
+  m_IdleTicks = 0;
+  if (m_TickTimer && m_TickTimer->interval() != TICK_MS)
+    m_TickTimer->start(TICK_MS);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1001,6 +1135,65 @@ void MainWindow::onOpenLogClicked()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MainWindow::onLogStatsClicked()
+{
+  qint64 elapsedNS = FS.GetStatsElapsedNS();
+
+  FrameScheduler::STATS stats;
+  FS.GetStats(stats);
+
+  // merge subscribers sharing a name, such as individual buttons
+  QMap<QString, FrameScheduler::sStats> merged;
+  QMap<QString, unsigned int> counts;
+  for (FrameScheduler::STATS::const_iterator i = stats.begin(); i != stats.end(); i++)
+  {
+    FrameScheduler::sStats &m = merged[i->name];
+    m.ticks += i->ticks;
+    m.costNS += i->costNS;
+    if (i->maxCostNS > m.maxCostNS)
+      m.maxCostNS = i->maxCostNS;
+    counts[i->name]++;
+  }
+
+  m_Log.AddInfo(QString("Frame scheduler: %1 subscribers over %2s").arg(stats.size()).arg(elapsedNS * 0.000000001, 0, 'f', 1).toUtf8().constData());
+
+  // timer and thread wakeups keep the cpu out of deep idle, so they are worth watching on their own
+  double seconds = (elapsedNS * 0.000000001);
+  unsigned int fsWakeups = FS.GetWakeups();
+  unsigned int genWakeups = GEN.TakeWakeups();
+  if (seconds > 0)
+  {
+    double total = ((fsWakeups + genWakeups + m_TickWakeups) / seconds);
+    m_Log.AddInfo(QString("Wakeups: %1/s (frames %2/s, generators %3/s, network poll %4/s)").arg(total, 0, 'f', 1).arg(fsWakeups / seconds, 0, 'f', 1).arg(genWakeups / seconds, 0, 'f', 1).arg(m_TickWakeups / seconds, 0, 'f', 1).toUtf8().constData());
+  }
+  m_TickWakeups = 0;
+
+  for (QMap<QString, FrameScheduler::sStats>::const_iterator i = merged.begin(); i != merged.end(); i++)
+  {
+    const FrameScheduler::sStats &m = i.value();
+    if (m.ticks != 0)
+    {
+      double avgUS = ((m.costNS * 0.001) / m.ticks);
+      double load = ((elapsedNS > 0) ? ((m.costNS * 100.0) / elapsedNS) : 0);
+      m_Log.AddInfo(QString("  %1 (x%2): %3 ticks, %4us avg, %5us max, %6% load").arg(i.key()).arg(counts[i.key()]).arg(m.ticks).arg(avgUS, 0, 'f', 1).arg(m.maxCostNS * 0.001, 0, 'f', 1).arg(load, 0, 'f', 2).toUtf8().constData());
+    }
+  }
+
+  FS.ResetStats();
+
+  const PixmapCache::sStats &imageStats = PMC.GetStats();
+  quint64 lookups = (imageStats.hits + imageStats.misses);
+  double hitRate = ((lookups != 0) ? ((imageStats.hits * 100.0) / lookups) : 0);
+  double avgDecodeMS = ((imageStats.decodes != 0) ? ((imageStats.decodeNS * 0.000001) / imageStats.decodes) : 0);
+  double avgScaleMS = ((imageStats.scales != 0) ? ((imageStats.scaleNS * 0.000001) / imageStats.scales) : 0);
+  double toMB = (1.0 / (1024 * 1024));
+  m_Log.AddInfo(QString("Image cache: %1 MB of %2 MB (%3 MB in %4 originals, %5 MB in %6 scaled)").arg((PMC.GetOriginalBytes() + PMC.GetScaledBytes()) * toMB, 0, 'f', 1).arg(PMC.GetBudgetMB()).arg(PMC.GetOriginalBytes() * toMB, 0, 'f', 1).arg(PMC.GetList().size()).arg(PMC.GetScaledBytes() * toMB, 0, 'f', 1).arg(PMC.GetScaledList().size()).toUtf8().constData());
+  m_Log.AddInfo(QString("  %1% hit rate (%2 hits, %3 misses), %4 decodes at %5ms avg %6ms max, %7 scales at %8ms avg, %9 evicted, %10 prefetched").arg(hitRate, 0, 'f', 1).arg(imageStats.hits).arg(imageStats.misses).arg(imageStats.decodes).arg(avgDecodeMS, 0, 'f', 2).arg(imageStats.maxDecodeNS * 0.000001, 0, 'f', 2).arg(imageStats.scales).arg(avgScaleMS, 0, 'f', 2).arg(imageStats.evictions).arg(imageStats.prefetches).toUtf8().constData());
+  PMC.ResetStats();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MainWindow::closeEvent(QCloseEvent *event)
 {
   if (event->spontaneous())
@@ -1274,12 +1467,23 @@ bool MainWindow::ToyClient_Send(bool local, char *buf, size_t size)
   {
     if (local)
     {
-      m_Toys->Recv(buf, size);
-      delete[] buf;
+      sLocalPacket localPacket;
+      if (!GetLocalHops(buf, qstrnlen(buf, static_cast<uint>(size)), localPacket.hops))
+      {
+        delete[] buf;
+        return false;
+      }
+
+      localPacket.packet.data = buf;
+      localPacket.packet.size = size;
+      QueueLocal(localPacket);
       return true;
     }
     else
     {
+      // the send is logged by the network thread, so show it promptly
+      WakeTick();
+
       sPacket packet;
       packet.data = buf;
       packet.size = size;
@@ -1304,9 +1508,168 @@ bool MainWindow::ToyClient_Send(bool local, char *buf, size_t size)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MainWindow::NetworkThreadClient_Pending()
+{
+  // called from the network threads, at most one wake is queued per tick
+  if (m_NetPending.testAndSetOrdered(0, 1))
+    QMetaObject::invokeMethod(this, "onNetPending", Qt::QueuedConnection);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MainWindow::ToyClient_ResourceRelativePathToAbsolute(QString &path)
 {
-  Toy::ResourceRelativePathToAbsolute(&m_Log, m_FilePath, path);
+  // label triggers resolve the same few names over and over, so only the first
+  // lookup of each touches the disk (and logs); a new layout or a change in a
+  // watched folder starts over
+  if (m_ResourcePathsFile != m_FilePath)
+  {
+    ClearResourcePaths();
+    m_ResourcePathsFile = m_FilePath;
+  }
+
+  RESOURCE_PATHS::const_iterator i = m_ResourcePaths.find(path);
+  if (i != m_ResourcePaths.end())
+  {
+    path = i->second;
+    return;
+  }
+
+  if (m_ResourcePaths.size() >= MAX_RESOURCE_PATHS)
+    ClearResourcePaths();
+
+  QString resourcePath(path);
+  Toy::ResourceRelativePathToAbsolute(&m_Log, m_FilePath, resourcePath);
+  m_ResourcePaths[path] = resourcePath;
+
+  if (m_ResourceWatcher && !resourcePath.isEmpty())
+  {
+    QString dir(QFileInfo(resourcePath).absolutePath());
+    if (!m_ResourceWatcher->directories().contains(dir) && QFileInfo::exists(dir))
+      m_ResourceWatcher->addPath(dir);
+  }
+
+  path = resourcePath;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::ClearResourcePaths()
+{
+  m_ResourcePaths.clear();
+
+  if (m_ResourceWatcher)
+  {
+    QStringList dirs(m_ResourceWatcher->directories());
+    if (!dirs.isEmpty())
+      m_ResourceWatcher->removePaths(dirs);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::onResourceDirChanged(const QString & /*path*/)
+{
+  ClearResourcePaths();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MainWindow::ToyClient_Send(const OSCPacketTemplate &packetTemplate, const float *values, size_t count)
+{
+  if (packetTemplate.GetLocal())
+  {
+    OSCLocalMessage msg;
+    return (packetTemplate.CreateLocal(values, count, msg) && ToyClient_SendLocal(msg));
+  }
+
+  size_t size = 0;
+  char *packet = packetTemplate.Create(values, count, size);
+  return (packet && ToyClient_Send(/*local*/false, packet, size));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MainWindow::ToyClient_SendLocal(const OSCLocalMessage &msg)
+{
+  const QByteArray &address = msg.GetAddress();
+  if (address.isEmpty())
+    return false;
+
+  sLocalPacket localPacket;
+  if (!GetLocalHops(address.constData(), static_cast<size_t>(address.size()), localPacket.hops))
+    return false;
+
+  localPacket.packet.data = 0;
+  localPacket.packet.size = 0;
+  localPacket.msg = msg;
+  QueueLocal(localPacket);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool MainWindow::GetLocalHops(const char *path, size_t pathLen, unsigned int &hops)
+{
+  // each local message caused by delivering another local message is one hop further along the chain
+  hops = (m_LocalHops + 1);
+  if (hops <= LOCAL_MAX_HOPS)
+    return true;
+
+  if (!m_LocalLoopReported)
+  {
+    m_LocalLoopReported = true;
+    QString str(QString::fromUtf8(path, static_cast<int>(pathLen)));
+    m_Log.AddWarning(tr("Local feedback loop detected at \"%1\", message dropped").arg(str).toUtf8().constData());
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::QueueLocal(const sLocalPacket &localPacket)
+{
+  // delivered on the next pass of the event loop, never from inside the sender
+  m_LocalQ.push_back(localPacket);
+
+  if (m_LocalTimer && !m_LocalTimer->isActive())
+    m_LocalTimer->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::GeneratorClient_Send(bool local, char *data, size_t size)
+{
+  // called from the generator thread
+  QMutexLocker locker(&m_NetMutex);
+
+  sPacket packet;
+  packet.data = data;
+  packet.size = size;
+
+  if (local)
+  {
+    // local delivery touches widgets, so hand it over to the gui thread
+    bool wake = m_GeneratorLocalQ.empty();
+    m_GeneratorLocalQ.push_back(packet);
+    if (wake)
+      QMetaObject::invokeMethod(this, "onGeneratorLocal", Qt::QueuedConnection);
+    return;
+  }
+
+  if (m_UdpOutThread)
+  {
+    if (m_UdpOutThread->Send(packet))
+      return;
+  }
+  else if (m_TcpClientThread)
+  {
+    if (m_TcpClientThread->Send(packet))
+      return;
+  }
+
+  delete[] data;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
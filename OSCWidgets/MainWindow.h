@@ -42,6 +42,10 @@
 #include "LogFile.h"
 #endif
 
+#ifndef GENERATOR_THREAD_H
+#include "GeneratorThread.h"
+#endif
+
 class LogWidget;
 class EosPlatform;
 class SettingsPanel;
@@ -122,7 +126,7 @@ protected:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class MainWindow : public QWidget, private Toy::Client
+class MainWindow : public QWidget, private Toy::Client, private GeneratorThread::GeneratorClient, private NetworkThreadClient
 {
   Q_OBJECT
 
@@ -137,12 +141,16 @@ protected:
 
 private slots:
   void onTick();
+  void onNetPending();
+  void onLocalTimeout();
+  void onGeneratorLocal();
   void onNewFileClicked();
   void onOpenFileClicked();
   void onSaveFileClicked();
   void onSaveAsFileClicked();
   void onClearLogClicked();
   void onOpenLogClicked();
+  void onLogStatsClicked();
   void onSettingsChanged();
   void onAdvancedClicked();
   void onAdvancedChanged();
@@ -163,6 +171,7 @@ private slots:
   void onSystemTrayToggleToys();
   void onSystemTrayExit();
   void onSystemTrayActivated(QSystemTrayIcon::ActivationReason reason);
+  void onResourceDirChanged(const QString &path);
 
 private:
   enum EnumConstants
@@ -171,9 +180,27 @@ private:
     TOY_TREE_COL_COUNT,
 
     TOY_TREE_ROLE_TOY_INDEX = Qt::UserRole,
-    TOY_TREE_ROLE_TOY_TYPE
+    TOY_TREE_ROLE_TOY_TYPE,
+
+    LOCAL_MAX_HOPS = 16,
+
+    TICK_MS = 100,
+    IDLE_TICK_MS = 1000,
+    IDLE_TICKS = 10,
+
+    MAX_RESOURCE_PATHS = 4096
   };
 
+  struct sLocalPacket
+  {
+    sPacket packet;       // serialized, or no data when msg is used
+    OSCLocalMessage msg;  // already typed
+    unsigned int hops;
+  };
+
+  typedef std::vector<sLocalPacket> LOCAL_PACKET_Q;
+  typedef std::map<QString, QString> RESOURCE_PATHS;
+
   EosLog m_Log;
   EosLog::LOG_Q m_TempLogQ;
   LogWidget *m_LogWidget;
@@ -190,8 +217,19 @@ private:
   EosUdpOutThread *m_UdpOutThread;
   EosUdpInThread *m_UdpInThread;
   EosTcpClientThread *m_TcpClientThread;
+  QRecursiveMutex m_NetMutex;
+  PACKET_Q m_GeneratorLocalQ;
   PACKET_Q m_RecvQ;
   NETEVENT_Q m_NetEventQ;
+  LOCAL_PACKET_Q m_LocalQ;
+  LOCAL_PACKET_Q m_LocalRecvQ;
+  unsigned int m_LocalHops;
+  bool m_LocalLoopReported;
+  QTimer *m_LocalTimer;
+  QTimer *m_TickTimer;
+  unsigned int m_IdleTicks;
+  unsigned int m_TickWakeups;
+  QAtomicInt m_NetPending;
   EosTreeWidget *m_ToyTree;
   Toys *m_Toys;
   size_t m_ToyTreeToyIndex;
@@ -200,6 +238,9 @@ private:
   QMenu *m_SystemTrayMenu;
   EosPlatform *m_pPlatform;
   bool m_SystemIdleAllowed;
+  RESOURCE_PATHS m_ResourcePaths;
+  QString m_ResourcePathsFile;
+  QFileSystemWatcher *m_ResourceWatcher;
 
   virtual void Start();
   virtual void Shutdown();
@@ -214,8 +255,18 @@ private:
   virtual void ProcessRecvQ();
   virtual void ClearNetEventQ();
   virtual void ProcessNetEventQ();
+  virtual void ClearLocalQ();
   virtual bool ToyClient_Send(bool local, char *data, size_t size);
+  virtual bool ToyClient_Send(const OSCPacketTemplate &packetTemplate, const float *values, size_t count);
+  virtual bool ToyClient_SendLocal(const OSCLocalMessage &msg);
+  virtual bool GetLocalHops(const char *path, size_t pathLen, unsigned int &hops);
+  virtual void QueueLocal(const sLocalPacket &localPacket);
   virtual void ToyClient_ResourceRelativePathToAbsolute(QString &path);
+  virtual EosLog &ToyClient_Log() { return m_Log; }
+  virtual void ClearResourcePaths();
+  virtual void GeneratorClient_Send(bool local, char *data, size_t size);
+  virtual void NetworkThreadClient_Pending();
+  virtual void WakeTick();
   virtual void PopulateToyTree();
   virtual void MakeToyIcon(const Toy &toy, const QSize &iconSize, QIcon &icon) const;
   virtual void LoadAdvancedSettings();
@@ -46,8 +46,9 @@ bool OSCHandler::ProcessPacket(OSCParserClient &client, char *buf, size_t size)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosUdpOutThread::EosUdpOutThread()
+EosUdpOutThread::EosUdpOutThread(NetworkThreadClient *pClient /*=0*/)
   : m_Port(0)
+  , m_pClient(pClient)
   , m_Run(false)
 {
 }
@@ -130,6 +131,7 @@ void EosUdpOutThread::run()
       m_Mutex.lock();
       m_NetEventQ.push_back(NET_EVENT_CONNECTED);
       m_Mutex.unlock();
+      NotifyPending();
 
       OSCParser logParser;
       logParser.SetRoot(new OSCMethod());
@@ -158,6 +160,7 @@ void EosUdpOutThread::run()
       m_Mutex.lock();
       m_NetEventQ.push_back(NET_EVENT_DISCONNECTED);
       m_Mutex.unlock();
+      NotifyPending();
     }
 
     delete udpOut;
@@ -200,8 +203,9 @@ void EosUdpOutThread::UpdateLog()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosUdpInThread::EosUdpInThread()
+EosUdpInThread::EosUdpInThread(NetworkThreadClient *pClient /*=0*/)
   : m_Port(0)
+  , m_pClient(pClient)
   , m_Run(false)
 {
 }
@@ -363,13 +367,16 @@ void EosUdpInThread::OSCHandlerClient_Recv(OSCParserClient & /*client*/, char *b
     m_Mutex.lock();
     m_Q.push_back(packet);
     m_Mutex.unlock();
+
+    NotifyPending();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-EosTcpClientThread::EosTcpClientThread()
+EosTcpClientThread::EosTcpClientThread(NetworkThreadClient *pClient /*=0*/)
   : m_Port(0)
+  , m_pClient(pClient)
   , m_LogMsgType(EosLog::LOG_MSG_TYPE_INFO)
   , m_Run(false)
 {
@@ -486,6 +493,7 @@ void EosTcpClientThread::run()
         m_Mutex.lock();
         m_NetEventQ.push_back(NET_EVENT_CONNECTED);
         m_Mutex.unlock();
+        NotifyPending();
 
         PACKET_Q sendQ;
         OSCStream oscStream(m_FrameMode);
@@ -544,6 +552,7 @@ void EosTcpClientThread::run()
         m_Mutex.lock();
         m_NetEventQ.push_back(NET_EVENT_DISCONNECTED);
         m_Mutex.unlock();
+        NotifyPending();
       }
     }
 
@@ -599,6 +608,8 @@ void EosTcpClientThread::OSCHandlerClient_Recv(OSCParserClient & /*client*/, cha
     m_Mutex.lock();
     m_RecvQ.push_back(packet);
     m_Mutex.unlock();
+
+    NotifyPending();
   }
 }
 
@@ -55,6 +55,15 @@ typedef std::vector<EnumNetworkEvent> NETEVENT_Q;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+class NetworkThreadClient
+{
+public:
+  // called from the network thread whenever received packets or network events are waiting to be flushed
+  virtual void NetworkThreadClient_Pending() = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class OSCHandler : public OSCMethod
 {
 public:
@@ -77,7 +86,7 @@ protected:
 class EosUdpOutThread : public QThread, private OSCParserClient
 {
 public:
-  EosUdpOutThread();
+  EosUdpOutThread(NetworkThreadClient *pClient = 0);
   virtual ~EosUdpOutThread();
 
   virtual void Start(const QString &ip, unsigned short port);
@@ -88,6 +97,7 @@ public:
 protected:
   QString m_Ip;
   unsigned short m_Port;
+  NetworkThreadClient *m_pClient;
   bool m_Run;
   EosLog m_Log;
   EosLog m_PrivateLog;
@@ -99,6 +109,11 @@ protected:
 
   virtual void run();
   virtual void UpdateLog();
+  virtual void NotifyPending()
+  {
+    if (m_pClient)
+      m_pClient->NetworkThreadClient_Pending();
+  }
 
 private:
   virtual void OSCParserClient_Log(const std::string &message);
@@ -110,7 +125,7 @@ private:
 class EosUdpInThread : public QThread, private OSCParserClient, private OSCHandler::Client
 {
 public:
-  EosUdpInThread();
+  EosUdpInThread(NetworkThreadClient *pClient = 0);
   virtual ~EosUdpInThread();
 
   virtual void Start(const QString &ip, unsigned short port);
@@ -120,6 +135,7 @@ public:
 protected:
   QString m_Ip;
   unsigned short m_Port;
+  NetworkThreadClient *m_pClient;
   bool m_Run;
   EosLog m_Log;
   EosLog m_PrivateLog;
@@ -130,6 +146,11 @@ protected:
 
   virtual void run();
   virtual void UpdateLog();
+  virtual void NotifyPending()
+  {
+    if (m_pClient)
+      m_pClient->NetworkThreadClient_Pending();
+  }
 
 private:
   virtual void OSCParserClient_Log(const std::string &message);
@@ -142,7 +163,7 @@ private:
 class EosTcpClientThread : public QThread, private OSCParserClient, private OSCHandler::Client
 {
 public:
-  EosTcpClientThread();
+  EosTcpClientThread(NetworkThreadClient *pClient = 0);
   virtual ~EosTcpClientThread();
 
   virtual void Start(const QString &ip, unsigned short port, OSCStream::EnumFrameMode frameMode);
@@ -154,6 +175,7 @@ protected:
   QString m_Ip;
   unsigned short m_Port;
   OSCStream::EnumFrameMode m_FrameMode;
+  NetworkThreadClient *m_pClient;
   bool m_Run;
   EosLog m_Log;
   EosLog m_PrivateLog;
@@ -167,6 +189,11 @@ protected:
 
   virtual void run();
   virtual void UpdateLog();
+  virtual void NotifyPending()
+  {
+    if (m_pClient)
+      m_pClient->NetworkThreadClient_Pending();
+  }
 
 private:
   virtual void OSCParserClient_Log(const std::string &message);
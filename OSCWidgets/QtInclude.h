@@ -46,6 +46,7 @@
 #define BUTTON_CLICK_MS 200
 #define BUTTON_BRIGHTESS 0.2f
 #define BUTTON_RAISE 6
+#define ANIMATION_MS 16
 
 #ifdef WIN32
 #include <Winsock2.h>
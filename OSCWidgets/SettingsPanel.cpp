@@ -68,12 +68,12 @@ AdvancedPanel::AdvancedPanel(QWidget *parent)
 
   ++row;
   m_MetroRefreshRate = new QLineEdit(this);
-  layout->addWidget(new QLabel(tr("Metronome Refresh Rate (ms)"), this), row, 0);
+  layout->addWidget(new QLabel(tr("Metronome Output Rate (ms)"), this), row, 0);
   layout->addWidget(m_MetroRefreshRate, row, 1);
 
   ++row;
   m_SineRefreshRate = new QLineEdit(this);
-  layout->addWidget(new QLabel(tr("Sine Wave Refresh Rate (ms)"), this), row, 0);
+  layout->addWidget(new QLabel(tr("Sine Wave Output Rate (ms)"), this), row, 0);
   layout->addWidget(m_SineRefreshRate, row, 1);
 
   ++row;
@@ -83,9 +83,33 @@ AdvancedPanel::AdvancedPanel(QWidget *parent)
 
   ++row;
   m_FlickerRefreshRate = new QLineEdit(this);
-  layout->addWidget(new QLabel(tr("Flicker Refresh Rate (ms)"), this), row, 0);
+  layout->addWidget(new QLabel(tr("Flicker Output Rate (ms)"), this), row, 0);
   layout->addWidget(m_FlickerRefreshRate, row, 1);
 
+  ++row;
+  m_MetroVisualRate = new QLineEdit(this);
+  m_MetroVisualRate->setToolTip(tr("Redraw interval, never faster than the screen refresh"));
+  layout->addWidget(new QLabel(tr("Metronome Visual Rate (ms)"), this), row, 0);
+  layout->addWidget(m_MetroVisualRate, row, 1);
+
+  ++row;
+  m_SineVisualRate = new QLineEdit(this);
+  m_SineVisualRate->setToolTip(m_MetroVisualRate->toolTip());
+  layout->addWidget(new QLabel(tr("Sine Wave Visual Rate (ms)"), this), row, 0);
+  layout->addWidget(m_SineVisualRate, row, 1);
+
+  ++row;
+  m_FlickerVisualRate = new QLineEdit(this);
+  m_FlickerVisualRate->setToolTip(m_MetroVisualRate->toolTip());
+  layout->addWidget(new QLabel(tr("Flicker Visual Rate (ms)"), this), row, 0);
+  layout->addWidget(m_FlickerVisualRate, row, 1);
+
+  ++row;
+  m_ImageCacheMB = new QLineEdit(this);
+  m_ImageCacheMB->setToolTip(tr("Memory for decoded and scaled images\nImages no longer in use are released least recently used first"));
+  layout->addWidget(new QLabel(tr("Image Cache (MB)"), this), row, 0);
+  layout->addWidget(m_ImageCacheMB, row, 1);
+
   ++row;
   QPushButton *button = new QPushButton(tr("Restore Defaults"), this);
   QPalette pal(button->palette());
@@ -113,6 +137,10 @@ void AdvancedPanel::Load()
   m_SineRefreshRate->setText(QString::number(Toy::GetSineRefreshRateMS()));
   m_PedalRefreshRate->setText(QString::number(Toy::GetPedalRefreshRateMS()));
   m_FlickerRefreshRate->setText(QString::number(Toy::GetFlickerRefreshRateMS()));
+  m_MetroVisualRate->setText(QString::number(Toy::GetMetroVisualRateMS()));
+  m_SineVisualRate->setText(QString::number(Toy::GetSineVisualRateMS()));
+  m_FlickerVisualRate->setText(QString::number(Toy::GetFlickerVisualRateMS()));
+  m_ImageCacheMB->setText(QString::number(PMC.GetBudgetMB()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,6 +155,10 @@ void AdvancedPanel::Save()
   Toy::SetSineRefreshRateMS(m_SineRefreshRate->text().toUInt());
   Toy::SetPedalRefreshRateMS(m_PedalRefreshRate->text().toUInt());
   Toy::SetFlickerRefreshRateMS(m_FlickerRefreshRate->text().toUInt());
+  Toy::SetMetroVisualRateMS(m_MetroVisualRate->text().toUInt());
+  Toy::SetSineVisualRateMS(m_SineVisualRate->text().toUInt());
+  Toy::SetFlickerVisualRateMS(m_FlickerVisualRate->text().toUInt());
+  PMC.SetBudgetMB(m_ImageCacheMB->text().toUInt());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,6 +175,7 @@ void AdvancedPanel::onApplyClicked(bool /*checked*/)
 void AdvancedPanel::onRestoreDefaultsClicked(bool /*checked*/)
 {
   Toy::RestoreDefaultSettings();
+  PMC.SetBudgetMB(PixmapCache::DEFAULT_BUDGET_MB);
   Load();
   emit changed();
 }
@@ -41,6 +41,11 @@
 #define SETTING_METRO_REFRESH_RATE "MetroRefreshRate"
 #define SETTING_SINE_REFRESH_RATE "SineWaveRefreshRate"
 #define SETTING_PEDAL_REFRESH_RATE "PedalRefreshRate"
+#define SETTING_FLICKER_REFRESH_RATE "FlickerRefreshRate"
+#define SETTING_METRO_VISUAL_RATE "MetroVisualRate"
+#define SETTING_SINE_VISUAL_RATE "SineWaveVisualRate"
+#define SETTING_FLICKER_VISUAL_RATE "FlickerVisualRate"
+#define SETTING_IMAGE_CACHE_MB "ImageCacheMB"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -88,6 +93,10 @@ protected:
   QLineEdit *m_SineRefreshRate;
   QLineEdit *m_PedalRefreshRate;
   QLineEdit *m_FlickerRefreshRate;
+  QLineEdit *m_MetroVisualRate;
+  QLineEdit *m_SineVisualRate;
+  QLineEdit *m_FlickerVisualRate;
+  QLineEdit *m_ImageCacheMB;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +52,9 @@ unsigned int Toy::sm_MetroRefreshRateMS = 0;
 unsigned int Toy::sm_SineRefreshRateMS = 0;
 unsigned int Toy::sm_PedalRefreshRateMS = 0;
 unsigned int Toy::sm_FlickerRefreshRateMS = 0;
+unsigned int Toy::sm_MetroVisualRateMS = 0;
+unsigned int Toy::sm_SineVisualRateMS = 0;
+unsigned int Toy::sm_FlickerVisualRateMS = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -319,6 +322,22 @@ void Toy::RestoreDefaultSettings()
   sm_SineRefreshRateMS = 10;
   sm_PedalRefreshRateMS = 10;
   sm_FlickerRefreshRateMS = 10;
+  sm_MetroVisualRateMS = 16;
+  sm_SineVisualRateMS = 16;
+  sm_FlickerVisualRateMS = 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int Toy::GetVisualIntervalMS(const QWidget &w, unsigned int visualMS)
+{
+  // never repaint faster than the screen can show it
+  QScreen *screen = w.screen();
+  qreal hz = (screen ? screen->refreshRate() : 0);
+  if (hz > 0)
+    visualMS = qMax(visualMS, static_cast<unsigned int>(qCeil(1000.0 / hz)));
+
+  return visualMS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
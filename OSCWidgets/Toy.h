@@ -34,6 +34,10 @@
 #include "ToyMath.h"
 #endif
 
+#ifndef UTILS_H
+#include "Utils.h"
+#endif
+
 #include <vector>
 
 class EosLog;
@@ -70,11 +74,14 @@ public:
   {
   public:
     virtual bool ToyClient_Send(bool local, char *data, size_t size) = 0;
+    virtual bool ToyClient_Send(const OSCPacketTemplate &packetTemplate, const float *values, size_t count) = 0;
+    virtual bool ToyClient_SendLocal(const OSCLocalMessage &msg) = 0;
     virtual void ToyClient_ResourceRelativePathToAbsolute(QString &path) = 0;
+    virtual EosLog &ToyClient_Log() = 0;
   };
 
-  typedef std::multimap<QString, ToyWidget *> RECV_WIDGETS;
-  typedef std::pair<QString, ToyWidget *> RECV_WIDGETS_PAIR;
+  typedef std::multimap<OSCAddressTable::ID, ToyWidget *> RECV_WIDGETS;
+  typedef std::pair<OSCAddressTable::ID, ToyWidget *> RECV_WIDGETS_PAIR;
   typedef std::pair<RECV_WIDGETS::const_iterator, RECV_WIDGETS::const_iterator> RECV_WIDGETS_RANGE;
 
   Toy(EnumToyType type, Client *pClient, QWidget *parent, Qt::WindowFlags flags);
@@ -82,6 +89,7 @@ public:
 
   EnumToyType GetType() const { return m_Type; }
   virtual void AddRecvWidgets(RECV_WIDGETS &recvWidgets) const = 0;
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const = 0;
   virtual void SnapToEdges();
   virtual bool Save(EosLog &log, const QString &path, QStringList &lines) = 0;
   virtual bool Load(EosLog &log, const QString &path, QStringList &lines, int &index) = 0;
@@ -130,6 +138,13 @@ public:
   static void SetPedalRefreshRateMS(unsigned int n) { sm_PedalRefreshRateMS = qBound(static_cast<unsigned int>(1), n, static_cast<unsigned int>(250)); }
   static unsigned int GetFlickerRefreshRateMS() { return sm_FlickerRefreshRateMS; }
   static void SetFlickerRefreshRateMS(unsigned int n) { sm_FlickerRefreshRateMS = qBound(static_cast<unsigned int>(1), n, static_cast<unsigned int>(60000)); }
+  static unsigned int GetMetroVisualRateMS() { return sm_MetroVisualRateMS; }
+  static void SetMetroVisualRateMS(unsigned int n) { sm_MetroVisualRateMS = qBound(static_cast<unsigned int>(1), n, static_cast<unsigned int>(1000)); }
+  static unsigned int GetSineVisualRateMS() { return sm_SineVisualRateMS; }
+  static void SetSineVisualRateMS(unsigned int n) { sm_SineVisualRateMS = qBound(static_cast<unsigned int>(1), n, static_cast<unsigned int>(1000)); }
+  static unsigned int GetFlickerVisualRateMS() { return sm_FlickerVisualRateMS; }
+  static void SetFlickerVisualRateMS(unsigned int n) { sm_FlickerVisualRateMS = qBound(static_cast<unsigned int>(1), n, static_cast<unsigned int>(1000)); }
+  static unsigned int GetVisualIntervalMS(const QWidget &w, unsigned int visualMS);
   static void RestoreDefaultSettings();
 
 signals:
@@ -149,6 +164,9 @@ protected:
   static unsigned int sm_SineRefreshRateMS;
   static unsigned int sm_PedalRefreshRateMS;
   static unsigned int sm_FlickerRefreshRateMS;
+  static unsigned int sm_MetroVisualRateMS;
+  static unsigned int sm_SineVisualRateMS;
+  static unsigned int sm_FlickerVisualRateMS;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
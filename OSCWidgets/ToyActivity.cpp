@@ -33,11 +33,10 @@ bool FadeActivity::sFadeTiming::operator==(const sFadeTiming &other) const
 
 FadeActivity::FadeActivity(QWidget *parent)
   : FadeButton_NoTouch(parent)
+  , m_Fading(false)
   , m_FadeState(FADE_OFF)
   , m_FadeElapsed(0)
 {
-  m_ActivityTimer = new QTimer(this);
-  connect(m_ActivityTimer, SIGNAL(timeout()), this, SLOT(onUpdate()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,7 +58,7 @@ void FadeActivity::SetFadeTiming(const sFadeTiming &fadeTiming)
   {
     m_FadeTiming = fadeTiming;
 
-    if (m_FadeState == FADE_ON && m_FadeTiming.hold != static_cast<unsigned int>(FADE_HOLD_INFINITE) && !m_ActivityTimer->isActive())
+    if (m_FadeState == FADE_ON && m_FadeTiming.hold != static_cast<unsigned int>(FADE_HOLD_INFINITE) && !m_Fading)
     {
       StartActivityTimer();
     }
@@ -78,17 +77,23 @@ void FadeActivity::SetOn(bool b)
         m_FadeElapsed = 0;
         m_FadeState = FADE_IN;
         StartActivityTimer();
-        onUpdate();
+        UpdateFade(0);
         break;
 
-      case FADE_IN: onUpdate(); break;
+      case FADE_IN: UpdateFade(0); break;
 
-      case FADE_ON: m_FadeElapsed = 0; break;
+      case FADE_ON:
+        // restart the hold from now
+        m_FadeElapsed = 0;
+        m_FadeClock.start();
+        FS.SetActive(*this, false);
+        UpdateAnimating();
+        break;
 
       case FADE_OUT:
         m_FadeElapsed = static_cast<unsigned int>(qRound((1.0f - GetFadePercent()) * m_FadeTiming.in));
         m_FadeState = FADE_IN;
-        onUpdate();
+        UpdateFade(0);
         break;
     }
   }
@@ -99,17 +104,17 @@ void FadeActivity::SetOn(bool b)
       case FADE_IN:
         m_FadeElapsed = static_cast<unsigned int>(qRound((1.0f - GetFadePercent()) * m_FadeTiming.out));
         m_FadeState = FADE_OUT;
-        onUpdate();
+        UpdateFade(0);
         break;
 
       case FADE_ON:
         m_FadeElapsed = 0;
         m_FadeState = FADE_OUT;
         StartActivityTimer();
-        onUpdate();
+        UpdateFade(0);
         break;
 
-      case FADE_OUT: onUpdate(); break;
+      case FADE_OUT: UpdateFade(0); break;
     }
   }
 }
@@ -118,8 +123,16 @@ void FadeActivity::SetOn(bool b)
 
 void FadeActivity::StartActivityTimer()
 {
-  m_ActivityEosTimer.Start();
-  m_ActivityTimer->start(20);
+  m_Fading = true;
+  UpdateAnimating();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeActivity::StopActivityTimer()
+{
+  m_Fading = false;
+  UpdateAnimating();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,9 +169,10 @@ float FadeActivity::GetFadePercent() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeActivity::onUpdate()
+void FadeActivity::UpdateFade(unsigned int ms)
 {
-  m_FadeElapsed += m_ActivityEosTimer.Restart();
+  m_FadeElapsed += ms;
+  m_FadeClock.start();
 
   switch (m_FadeState)
   {
@@ -168,6 +182,7 @@ void FadeActivity::onUpdate()
       {
         m_FadeState = FADE_ON;
         m_FadeElapsed = 0;
+        UpdateAnimating();
       }
     }
     break;
@@ -176,12 +191,13 @@ void FadeActivity::onUpdate()
     {
       if (m_FadeTiming.hold == static_cast<unsigned int>(FADE_HOLD_INFINITE))
       {
-        m_ActivityTimer->stop();
+        StopActivityTimer();
       }
       else if (GetFadePercent() >= 1.0f)
       {
         m_FadeState = FADE_OUT;
         m_FadeElapsed = 0;
+        UpdateAnimating();
       }
     }
     break;
@@ -191,12 +207,12 @@ void FadeActivity::onUpdate()
       if (GetFadePercent() >= 1.0f)
       {
         m_FadeState = FADE_OFF;
-        m_ActivityTimer->stop();
+        StopActivityTimer();
       }
     }
     break;
 
-    default: m_ActivityTimer->stop(); break;
+    default: StopActivityTimer(); break;
   }
 
   update();
@@ -204,6 +220,76 @@ void FadeActivity::onUpdate()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void FadeActivity::CatchUpFade(unsigned int ms)
+{
+  // each stage restarts m_FadeElapsed, so spend the time one stage at a time
+  while (m_Fading)
+  {
+    unsigned int duration = 0;
+    switch (m_FadeState)
+    {
+      case FADE_IN: duration = m_FadeTiming.in; break;
+      case FADE_ON: duration = m_FadeTiming.hold; break;
+      case FADE_OUT: duration = m_FadeTiming.out; break;
+      default: break;
+    }
+
+    unsigned int step = ((duration > m_FadeElapsed) ? qMin(ms, duration - m_FadeElapsed) : 0);
+    EnumFadeState fadeState = m_FadeState;
+    UpdateFade(step);
+    ms -= step;
+
+    if (ms == 0 && m_FadeState == fadeState)
+      break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool FadeActivity::IsAnimating() const
+{
+  return (m_Fading || FadeButton_NoTouch::IsAnimating());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeActivity::UpdateAnimating()
+{
+  // nothing changes on screen during a timed hold, so sleep through the rest of it in one tick
+  unsigned int intervalMS = ANIMATION_MS;
+  if (m_Fading && m_FadeState == FADE_ON && m_FadeTiming.hold != static_cast<unsigned int>(FADE_HOLD_INFINITE) && !FadeButton_NoTouch::IsAnimating())
+  {
+    if (m_FadeTiming.hold > m_FadeElapsed)
+      intervalMS = qMax(intervalMS, m_FadeTiming.hold - m_FadeElapsed);
+  }
+
+  FS.SetInterval(*this, intervalMS);
+  FadeButton_NoTouch::UpdateAnimating();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeActivity::FrameSchedulerClient_Tick(unsigned int ms)
+{
+  FadeButton_NoTouch::FrameSchedulerClient_Tick(ms);
+
+  if (m_Fading)
+    UpdateFade(ms);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeActivity::showEvent(QShowEvent *event)
+{
+  // fades stop ticking while hidden, so pick up where they would be by now
+  if (m_Fading && m_FadeClock.isValid())
+    CatchUpFade(static_cast<unsigned int>(qMin(m_FadeClock.elapsed(), static_cast<qint64>(0x7fffffff))));
+
+  FadeButton_NoTouch::showEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void FadeActivity::paintEvent(QPaintEvent * /*event*/)
 {
   QRectF r(rect());
@@ -223,7 +309,7 @@ void FadeActivity::paintEvent(QPaintEvent * /*event*/)
   }
   else
   {
-    painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, r, pixmap);
   }
 
   painter.setOpacity(1.0);
@@ -237,35 +323,7 @@ void FadeActivity::paintEvent(QPaintEvent * /*event*/)
 
   QColor textColor(palette().color(QPalette::ButtonText));
 
-  if (!text().isEmpty())
-  {
-    if (m_Label.isEmpty())
-    {
-      // just text centered
-      painter.setPen(textColor);
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap, text());
-    }
-    else
-    {
-      // both text and label text
-      QRectF textRect;
-      painter.setPen(textColor);
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap | Qt::TextDontPrint, text(), &textRect);
-
-      QRectF labelRect;
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap | Qt::TextDontPrint, m_Label, &labelRect);
-
-      qreal h = (r.height() * 0.5 * (textRect.height() / labelRect.height()));
-      painter.drawText(QRectF(r.x(), r.y(), r.width(), h), Qt::AlignCenter | Qt::TextWordWrap, text());
-      painter.drawText(QRectF(r.x(), r.y() + h, r.width(), r.height() - h), Qt::AlignCenter | Qt::TextWordWrap, m_Label);
-    }
-  }
-  else if (!m_Label.isEmpty())
-  {
-    // just label text centered
-    painter.setPen(textColor);
-    painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap, m_Label);
-  }
+  RenderText(painter, r, textColor);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -275,9 +333,10 @@ ToyActivityWidget::ToyActivityWidget(QWidget *parent)
   , m_FadeDuration(static_cast<unsigned int>(FadeActivity::FADE_HOLD_INFINITE))
   , m_HoldDuration(static_cast<unsigned int>(FadeActivity::FADE_HOLD_INFINITE))
 {
-  m_Min = "0.001";
-  m_Max = "1000.0";
-  m_Min2 = m_Max2 = QString();
+  ToyWidget::SetMin("0.001");
+  ToyWidget::SetMax("1000.0");
+  ToyWidget::SetMin2(QString());
+  ToyWidget::SetMax2(QString());
   m_HelpText =
       tr("If Min or Max blank, flash on any activity\n\nOSC Trigger:\nNo Arguments = Flash\nArgument(inside Min/Max range) = On\nArgument(outside Min/Max range) = Off\n\nOptional:\nMin2 = Fade "
          "Duration (ms)\nMax2 = Hold Duration (ms)");
@@ -417,8 +476,8 @@ void ToyActivityWidget::Recv(const QString &path, const OSCArgument *args, size_
       float f = 0;
       if (args[0].GetFloat(f))
       {
-        float rangeMin = m_Min.toFloat();
-        float rangeMax = m_Max.toFloat();
+        float rangeMin = m_MinValue.value;
+        float rangeMax = m_MaxValue.value;
         if (rangeMin > rangeMax)
           qSwap(rangeMin, rangeMax);
         if (f >= rangeMin && f <= rangeMax)
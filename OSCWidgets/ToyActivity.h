@@ -65,9 +65,6 @@ public:
   virtual void SetFadeTiming(const sFadeTiming &fadeTiming);
   virtual void SetOn(bool b);
 
-private slots:
-  void onUpdate();
-
 protected:
   enum EnumFadeState
   {
@@ -77,15 +74,22 @@ protected:
     FADE_OUT
   };
 
-  QTimer *m_ActivityTimer;
-  EosTimer m_ActivityEosTimer;
+  bool m_Fading;
   sFadeTiming m_FadeTiming;
   EnumFadeState m_FadeState;
   unsigned int m_FadeElapsed;
+  QElapsedTimer m_FadeClock;  // since the last UpdateFade, to catch up after being hidden
 
   virtual float GetFadeOpacity() const;
   virtual float GetFadePercent() const;
   virtual void StartActivityTimer();
+  virtual void StopActivityTimer();
+  virtual void UpdateFade(unsigned int ms);
+  virtual void CatchUpFade(unsigned int ms);
+  virtual bool IsAnimating() const;
+  virtual void UpdateAnimating();
+  virtual void FrameSchedulerClient_Tick(unsigned int ms);
+  virtual void showEvent(QShowEvent *event);
   virtual void paintEvent(QPaintEvent *event);
 };
 
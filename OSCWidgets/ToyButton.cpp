@@ -28,23 +28,78 @@
 ToyButtonWidget::ToyButtonWidget(QWidget *parent)
   : ToyWidget(parent)
   , m_Toggle(false)
+  , m_Down(false)
 {
   m_HelpText =
       tr("Min = Button Up\nMax = Button Down\n\nLeave Min or Max blank to send single edge\n\nLeave both blank to send without arguments\n\nToggle:\nSpecify Min2 and/or Max2 for toggle "
          "behavior\n\nOSC Trigger:\nNo Arguments = Click\nArgument(1) = Press\nArgument(0) = Release");
-  m_Min2 = m_Max2 = QString();
+  ToyWidget::SetMin2(QString());
+  ToyWidget::SetMax2(QString());
 
-  m_Widget = new FadeButton(this);
-  connect(m_Widget, SIGNAL(pressed()), this, SLOT(onPressed()));
-  connect(m_Widget, SIGNAL(released()), this, SLOT(onReleased()));
-
-  QPalette pal(m_Widget->palette());
+  // the FadeButton itself is created on first show, so a cell the grid paints never needs one
+  QPalette pal(palette());
   m_Color = pal.color(QPalette::Button);
   m_TextColor = pal.color(QPalette::ButtonText);
   m_Color2 = m_TextColor;
   m_TextColor2 = m_Color;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FadeButton *ToyButtonWidget::GetButton() const
+{
+  return static_cast<FadeButton *>(m_Widget);
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void ToyButtonWidget::CreateButton()
+{
+  if (m_Widget)
+    return;
+
+  FadeButton *button = new FadeButton(this);
+  connect(button, SIGNAL(pressed()), this, SLOT(onPressed()));
+  connect(button, SIGNAL(released()), this, SLOT(onReleased()));
+  button->setText(m_Text);
+  button->SetImagePath(0, m_ImagePath);
+  button->SetImagePath(1, m_ImagePath2);
+  button->SetLabel(m_Label);
+  button->setDown(m_Down);
+  button->setGeometry(MARGIN, MARGIN, width() - MARGIN2, height() - MARGIN2);
+  m_Widget = button;
+
+  setToolTip(QString());
+  UpdateToolTip();
   UpdateToggleState();
+
+  button->show();
+  m_EditButton->raise();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyButtonWidget::ReleaseButton()
+{
+  FadeButton *button = GetButton();
+  if (button)
+  {
+    m_Down = button->isDown();
+    m_Widget = 0;
+    button->hide();
+    button->deleteLater();
+    UpdateToolTip();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyButtonWidget::UpdatePaintedByGrid()
+{
+  if (m_PaintedByGrid && !isVisible())
+    ReleaseButton();
+
+  UpdateCell();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,7 +107,9 @@ ToyButtonWidget::ToyButtonWidget(QWidget *parent)
 void ToyButtonWidget::SetText(const QString &text)
 {
   ToyWidget::SetText(text);
-  static_cast<FadeButton *>(m_Widget)->setText(m_Text);
+  if (m_Widget)
+    GetButton()->setText(m_Text);
+  UpdateCell();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,7 +117,9 @@ void ToyButtonWidget::SetText(const QString &text)
 void ToyButtonWidget::SetImagePath(const QString &imagePath)
 {
   ToyWidget::SetImagePath(imagePath);
-  static_cast<FadeButton *>(m_Widget)->SetImagePath(0, m_ImagePath);
+  if (m_Widget)
+    GetButton()->SetImagePath(0, m_ImagePath);
+  UpdateCell();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,7 +127,9 @@ void ToyButtonWidget::SetImagePath(const QString &imagePath)
 void ToyButtonWidget::SetImagePath2(const QString &imagePath2)
 {
   ToyWidget::SetImagePath2(imagePath2);
-  static_cast<FadeButton *>(m_Widget)->SetImagePath(1, m_ImagePath2);
+  if (m_Widget)
+    GetButton()->SetImagePath(1, m_ImagePath2);
+  UpdateCell();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,7 +168,10 @@ void ToyButtonWidget::SetTextColor2(const QColor &textColor2)
 
 void ToyButtonWidget::SetLabel(const QString &label)
 {
-  static_cast<FadeButton *>(m_Widget)->SetLabel(label);
+  m_Label = label;
+  if (m_Widget)
+    GetButton()->SetLabel(m_Label);
+  UpdateCell();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -125,24 +189,73 @@ void ToyButtonWidget::SetToggle(bool b)
 
 void ToyButtonWidget::UpdateToggleState()
 {
-  FadeButton *button = static_cast<FadeButton *>(m_Widget);
+  FadeButton *button = GetButton();
+  if (button)
+  {
+    bool toggled = (HasToggle() && m_Toggle);
 
+    QPalette pal(button->palette());
+    pal.setColor(QPalette::Button, toggled ? m_Color2 : m_Color);
+    pal.setColor(QPalette::ButtonText, toggled ? m_TextColor2 : m_TextColor);
+    button->setPalette(pal);
+
+    button->SetImageIndex(toggled ? 1 : 0);
+  }
+
+  UpdateCell();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyButtonWidget::GetCell(sCell &cell) const
+{
   bool toggled = (HasToggle() && m_Toggle);
 
-  QPalette pal(m_Widget->palette());
-  pal.setColor(QPalette::Button, toggled ? m_Color2 : m_Color);
-  pal.setColor(QPalette::ButtonText, toggled ? m_TextColor2 : m_TextColor);
-  button->setPalette(pal);
+  cell.visible = m_Visible;
+  cell.down = m_Down;
+  cell.text = m_Text;
+  cell.label = m_Label;
+  cell.imagePath = (toggled ? m_ImagePath2 : m_ImagePath);
+  cell.color = (toggled ? m_Color2 : m_Color);
+  cell.textColor = (toggled ? m_TextColor2 : m_TextColor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-  button->SetImageIndex(toggled ? 1 : 0);
+void ToyButtonWidget::Press(bool user /* =true */)
+{
+  FadeButton *button = GetButton();
+  if (button)
+    button->Press(user);
+  else if (!m_Down)
+  {
+    m_Down = true;
+    if (user)
+      onPressed();
+    UpdateCell();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToyButtonWidget::Recv(const QString &path, const OSCArgument *args, size_t count)
+void ToyButtonWidget::Release(bool user /* =true */)
 {
-  FadeButton *button = static_cast<FadeButton *>(m_Widget);
+  FadeButton *button = GetButton();
+  if (button)
+    button->Release(user);
+  else if (m_Down)
+  {
+    m_Down = false;
+    if (user)
+      onReleased();
+    UpdateCell();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void ToyButtonWidget::Recv(const QString &path, const OSCArgument *args, size_t count)
+{
   bool isFeedback = (path == m_FeedbackPath);
   bool isTrigger = (!isFeedback && path == m_TriggerPath);
   if (isFeedback || isTrigger)
@@ -155,14 +268,14 @@ void ToyButtonWidget::Recv(const QString &path, const OSCArgument *args, size_t
       if (gotAction)
       {
         if (press)
-          button->Press();
+          Press();
         else
-          button->Release();
+          Release();
       }
       else
       {
-        button->Press();
-        button->Release();
+        Press();
+        Release();
       }
     }
     else if (HasToggle())
@@ -175,14 +288,14 @@ void ToyButtonWidget::Recv(const QString &path, const OSCArgument *args, size_t
     else if (gotAction)
     {
       if (press)
-        button->Press(/*user*/ false);
+        Press(/*user*/ false);
       else
-        button->Release(/*user*/ false);
+        Release(/*user*/ false);
     }
     else
     {
-      button->Press(/*user*/ false);
-      button->Release(/*user*/ false);
+      Press(/*user*/ false);
+      Release(/*user*/ false);
     }
   }
   else
@@ -207,25 +320,25 @@ bool ToyButtonWidget::GetActionFromOSCArguments(const OSCArgument *args, size_t
     float f = 0;
     if (args[0].GetFloat(f))
     {
-      if (!m_Min.isEmpty() && OSC_IS_ABOUTF(f, m_Min.toFloat()))
+      if (!m_MinValue.isEmpty && OSC_IS_ABOUTF(f, m_MinValue.value))
       {
         toggle = false;
         press = false;
         return true;
       }
-      else if (!m_Max.isEmpty() && OSC_IS_ABOUTF(f, m_Max.toFloat()))
+      else if (!m_MaxValue.isEmpty && OSC_IS_ABOUTF(f, m_MaxValue.value))
       {
         toggle = false;
         press = true;
         return true;
       }
-      else if (!m_Min2.isEmpty() && OSC_IS_ABOUTF(f, m_Min2.toFloat()))
+      else if (!m_Min2Value.isEmpty && OSC_IS_ABOUTF(f, m_Min2Value.value))
       {
         toggle = true;
         press = false;
         return true;
       }
-      else if (!m_Max2.isEmpty() && OSC_IS_ABOUTF(f, m_Max2.toFloat()))
+      else if (!m_Max2Value.isEmpty && OSC_IS_ABOUTF(f, m_Max2Value.value))
       {
         toggle = true;
         press = true;
@@ -256,6 +369,24 @@ void ToyButtonWidget::onReleased()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyButtonWidget::showEvent(QShowEvent *event)
+{
+  CreateButton();
+  ToyWidget::showEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyButtonWidget::hideEvent(QHideEvent *event)
+{
+  ToyWidget::hideEvent(event);
+
+  if (m_PaintedByGrid)
+    ReleaseButton();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ToyButtonGrid::ToyButtonGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags)
   : ToyGrid(TOY_BUTTON_GRID, pClient, parent, flags)
 {
@@ -283,14 +414,14 @@ bool ToyButtonGrid::SendButtonCommand(ToyButtonWidget *button, bool press)
     if (hasMinMax)
     {
       if (hasMinMax2 && button->GetToggle())
-        return SendButtonCommand(button->GetPath(), button->GetMin2(), button->GetMax2(), press);
+        return SendButtonCommand(button->GetPathId(), button->GetMin2(), button->GetMin2Value(), button->GetMax2(), button->GetMax2Value(), press);
       else
-        return SendButtonCommand(button->GetPath(), button->GetMin(), button->GetMax(), press);
+        return SendButtonCommand(button->GetPathId(), button->GetMin(), button->GetMinValue(), button->GetMax(), button->GetMaxValue(), press);
     }
     else if (hasMinMax2)
-      return SendButtonCommand(button->GetPath(), button->GetMin2(), button->GetMax2(), press);
+      return SendButtonCommand(button->GetPathId(), button->GetMin2(), button->GetMin2Value(), button->GetMax2(), button->GetMax2Value(), press);
 
-    return SendButtonCommand(button->GetPath(), QString(), QString(), press);
+    return SendButtonCommand(button->GetPathId(), QString(), ToyWidget::sValue(), QString(), ToyWidget::sValue(), press);
   }
 
   return false;
@@ -298,15 +429,16 @@ bool ToyButtonGrid::SendButtonCommand(ToyButtonWidget *button, bool press)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool ToyButtonGrid::SendButtonCommand(const QString &path, const QString &minStr, const QString &maxStr, bool press)
+bool ToyButtonGrid::SendButtonCommand(OSCAddressTable::ID pathId, const QString &minStr, const ToyWidget::sValue &minValue, const QString &maxStr, const ToyWidget::sValue &maxValue, bool press)
 {
   bool shouldSend = false;
   bool forceStrArg = false;
-  QString value;
+  const QString *value = 0;
+  const ToyWidget::sValue *numericValue = 0;
 
-  if (minStr.isEmpty())
+  if (minValue.isEmpty)
   {
-    if (maxStr.isEmpty())
+    if (maxValue.isEmpty)
     {
       // none
       if (press)
@@ -317,46 +449,61 @@ bool ToyButtonGrid::SendButtonCommand(const QString &path, const QString &minStr
       // max only
       if (press)
       {
-        value = maxStr;
+        value = &maxStr;
+        numericValue = &maxValue;
         shouldSend = true;
       }
     }
   }
-  else if (maxStr.isEmpty())
+  else if (maxValue.isEmpty)
   {
     // min only
     if (!press)
     {
-      value = minStr;
+      value = &minStr;
+      numericValue = &minValue;
       shouldSend = true;
     }
   }
   else
   {
     // both
-    value = (press ? maxStr : minStr);
+    value = (press ? &maxStr : &minStr);
+    numericValue = (press ? &maxValue : &minValue);
     shouldSend = true;
-    if (!OSCArgument::IsFloatString(minStr.toUtf8().constData()) || !OSCArgument::IsFloatString(maxStr.toUtf8().constData()))
+    if (!minValue.isFloat || !maxValue.isFloat)
       forceStrArg = true;  // if either is non-numeric, send both as strings
   }
 
   if (shouldSend)
   {
-    QString oscPath(path);
-    bool local = Utils::MakeLocalOSCPath(false, oscPath);
-    OSCPacketWriter packetWriter(oscPath.toUtf8().constData());
-    if (!value.isEmpty())
+    const OSCAddressTable::sAddress &address = OAT.Get(pathId);
+    if (address.local)
+    {
+      OSCLocalMessage msg(address.utf8);
+      if (value && numericValue)
+      {
+        if (!forceStrArg && numericValue->isFloat)
+          msg.AddFloat32(numericValue->value);
+        else
+          msg.AddString(value->toUtf8());
+      }
+
+      return m_pClient->ToyClient_SendLocal(msg);
+    }
+
+    OSCPacketWriter packetWriter(address.utf8.constData());
+    if (value && numericValue)
     {
-      QByteArray ba(value.toUtf8());
-      if (!forceStrArg && OSCArgument::IsFloatString(ba.constData()))
-        packetWriter.AddFloat32(value.toFloat());
+      if (!forceStrArg && numericValue->isFloat)
+        packetWriter.AddFloat32(numericValue->value);
       else
-        packetWriter.AddString(ba.constData());
+        packetWriter.AddString(value->toUtf8().constData());
     }
 
     size_t size;
     char *packet = packetWriter.Create(size);
-    if (packet && m_pClient->ToyClient_Send(local, packet, size))
+    if (packet && m_pClient->ToyClient_Send(/*local*/false, packet, size))
       return true;
   }
 
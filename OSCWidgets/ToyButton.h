@@ -60,6 +60,11 @@ public:
   virtual bool HasMin2OrMax2() const { return (!m_Min2.isEmpty() || !m_Max2.isEmpty()); }
   virtual bool HasToggle() const { return (HasMinOrMax() && HasMin2OrMax2()); }
   virtual bool GetActionFromOSCArguments(const OSCArgument *args, size_t count, bool &toggle, bool &press) const;
+  virtual void Press(bool user = true);
+  virtual void Release(bool user = true);
+  virtual void GetCell(sCell &cell) const;
+  virtual void PressCell() { Press(); }
+  virtual void ReleaseCell() { Release(); }
 
 signals:
   void pressed(ToyButtonWidget *);
@@ -71,8 +76,16 @@ private slots:
 
 protected:
   bool m_Toggle;
+  bool m_Down;
+  QString m_Label;
 
+  virtual FadeButton *GetButton() const;
+  virtual void CreateButton();
+  virtual void ReleaseButton();
   virtual void UpdateToggleState();
+  virtual void UpdatePaintedByGrid();
+  virtual void showEvent(QShowEvent *event);
+  virtual void hideEvent(QHideEvent *event);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -85,6 +98,7 @@ public:
   ToyButtonGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags);
 
   virtual void GetDefaultGridSize(QSize &gridSize) const { gridSize = QSize(5, 1); }
+  virtual bool HasPaintedCells() const { return true; }
 
 private slots:
   void onPressed(ToyButtonWidget *);
@@ -94,7 +108,7 @@ protected:
   virtual ToyWidget *CreateWidget();
 
   virtual bool SendButtonCommand(ToyButtonWidget *button, bool press);
-  virtual bool SendButtonCommand(const QString &path, const QString &minStr, const QString &maxStr, bool press);
+  virtual bool SendButtonCommand(OSCAddressTable::ID pathId, const QString &minStr, const ToyWidget::sValue &minValue, const QString &maxStr, const ToyWidget::sValue &maxValue, bool press);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -234,7 +234,7 @@ void FadeEncoder::paintEvent(QPaintEvent * /*event*/)
     QPainterPath clip;
     clip.addEllipse(r);
     painter.setClipPath(clip);
-    painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, r, pixmap);
     painter.setClipping(false);
   }
 
@@ -286,8 +286,8 @@ ToyEncoderWidget::ToyEncoderWidget(QWidget *parent)
 {
   m_HelpText = tr("Min = Counter-Clockwise Tick\nMax = Clockwise Tick\n\nOSC Trigger:\nNo Arguments = Single CW Tick\nArgument(X) = X CW Ticks\nArgument(-X) = X CCW Ticks");
 
-  m_Min = "-1";
-  m_Max = "1";
+  ToyWidget::SetMin("-1");
+  ToyWidget::SetMax("1");
 
   m_Widget = new FadeEncoder(this);
   connect(m_Widget, SIGNAL(tick(float)), this, SLOT(onTick(float)));
@@ -401,30 +401,30 @@ void ToyEncoderGrid::onTick(ToyEncoderWidget *encoder, float radians)
 {
   if (m_pClient && encoder && !encoder->GetPath().isEmpty())
   {
-    QString path(encoder->GetPath());
-    bool local = Utils::MakeLocalOSCPath(false, path);
+    float value = 0;
+    size_t floatCount = 1;
 
-    OSCPacketWriter packetWriter(path.toUtf8().constData());
+    const ToyWidget::sValue &minValue = encoder->GetMinValue();
+    const ToyWidget::sValue &maxValue = encoder->GetMaxValue();
 
-    if (encoder->GetMin().isEmpty())
+    if (minValue.isEmpty)
     {
-      if (!encoder->GetMax().isEmpty())
-        packetWriter.AddFloat32(encoder->GetMax().toFloat());
+      if (maxValue.isEmpty)
+        floatCount = 0;
+      else
+        value = maxValue.value;
     }
-    else if (encoder->GetMax().isEmpty())
+    else if (maxValue.isEmpty)
     {
-      packetWriter.AddFloat32(encoder->GetMin().toFloat());
+      value = minValue.value;
     }
     else
     {
-      float value = ((radians < 0) ? encoder->GetMin().toFloat() : encoder->GetMax().toFloat());
-      packetWriter.AddFloat32(value);
+      value = ((radians < 0) ? minValue.value : maxValue.value);
     }
 
-    size_t size;
-    char *packet = packetWriter.Create(size);
-    if (packet)
-      m_pClient->ToyClient_Send(local, packet, size);
+    const OSCPacketTemplate &packetTemplate = encoder->GetPathTemplate(floatCount);
+    m_pClient->ToyClient_Send(packetTemplate, &value, floatCount);
   }
 }
 
@@ -32,12 +32,22 @@ FadeFlicker::FadeFlicker(QWidget *parent)
   , m_MinTimeScale(0)
   , m_MaxTimeScale(0)
   , m_BPM(600)
-  , m_MsPerBeat(0)
-  , m_Elapsed(0)
   , m_Paused(true)
+  , m_Clocked(false)
+  , m_Seeded(false)
+  , m_Seed(0)
 {
   connect(this, SIGNAL(clicked(bool)), this, SLOT(onClicked(bool)));
-  UpdateMsPerBeat();
+
+  m_GeneratorId = GEN.Add(GeneratorThread::GENERATOR_FLICKER, Toy::GetFlickerRefreshRateMS());
+  GEN.SetBPM(m_GeneratorId, m_BPM);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FadeFlicker::~FadeFlicker()
+{
+  GEN.Remove(m_GeneratorId);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,7 +82,7 @@ void FadeFlicker::SetTimeScaleRange(float minTimeScale, float maxTimeScale)
   {
     m_MinTimeScale = minTimeScale;
     m_MaxTimeScale = maxTimeScale;
-    UpdateMsPerBeat();
+    GEN.SetTimeScaleRange(m_GeneratorId, m_MinTimeScale, m_MaxTimeScale);
   }
 }
 
@@ -117,7 +127,7 @@ void FadeFlicker::SetBPM(float bpm)
   if (m_BPM != bpm)
   {
     m_BPM = bpm;
-    UpdateMsPerBeat();
+    GEN.SetBPM(m_GeneratorId, m_BPM);
   }
 }
 
@@ -128,65 +138,62 @@ void FadeFlicker::SetPaused(bool b)
   if (m_Paused != b)
   {
     m_Paused = b;
-    m_Elapsed = 0;
+
+    // a seeded flicker replays the same sequence every time it starts
+    if (!m_Paused && m_Seeded)
+      GEN.SetSeed(m_GeneratorId, m_Seed);
+
+    GEN.SetPaused(m_GeneratorId, m_Paused);
     update();
+    emit pausedChanged();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeFlicker::Update(unsigned int ms)
+void FadeFlicker::SetClock(const QString &clock)
 {
-  if (!m_Paused && ms != 0 && m_MsPerBeat != 0)
-  {
-    m_Elapsed += ms;
-
-    while (m_MsPerBeat != 0 && m_Elapsed >= m_MsPerBeat)
-    {
-      m_Elapsed -= m_MsPerBeat;
-      m_Value = (rand() / static_cast<float>(RAND_MAX));
-      emit valueChanged(m_Value);
-      if (HasTimeScale())
-        UpdateMsPerBeat();
-      update();
-    }
-  }
+  m_Clocked = !clock.isEmpty();
+  GEN.SetClock(m_GeneratorId, clock);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool FadeFlicker::HasTimeScale() const
+void FadeFlicker::SetSeed(bool seeded, quint32 seed)
 {
-  return (m_MinTimeScale > 0 && m_MaxTimeScale > 0);
+  m_Seeded = seeded;
+  m_Seed = seed;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-unsigned int FadeFlicker::GetMsPerBeat(float bpm, float timeScale)
+void FadeFlicker::Update(unsigned int /*ms*/)
 {
-  float scaledBMP = (bpm * timeScale);
-
-  unsigned int msPerBeat = ((scaledBMP > 0) ? (60000.0f / scaledBMP) : 0);
-
-  if (bpm > 0 && msPerBeat == 0)
-    msPerBeat = 1;
+  // the generator thread picks and sends values, just follow it for drawing
+  GeneratorThread::sState state;
+  if ((!m_Paused || m_Clocked) && GEN.GetState(m_GeneratorId, state))
+  {
+    // a clocked widget can also be started or stopped by its group
+    if (m_Paused != state.paused)
+    {
+      m_Paused = state.paused;
+      update();
+      emit pausedChanged();
+    }
 
-  return msPerBeat;
+    if (m_Value != state.value)
+    {
+      m_Value = state.value;
+      update();
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeFlicker::UpdateMsPerBeat()
+bool FadeFlicker::HasTimeScale() const
 {
-  float timeScale = 1.0f;
-
-  if (HasTimeScale())
-  {
-    float t = (rand() / static_cast<float>(RAND_MAX));
-    timeScale = (m_MinTimeScale * t + m_MaxTimeScale * (1.0f - t));
-  }
-
-  m_MsPerBeat = GetMsPerBeat(m_BPM, timeScale);
+  return (m_MinTimeScale > 0 && m_MaxTimeScale > 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -213,7 +220,7 @@ void FadeFlicker::paintEvent(QPaintEvent * /*event*/)
   const QPixmap &pixmap = m_Images[m_ImageIndex].pixmap;
   if (!pixmap.isNull())
   {
-    painter.drawPixmap(m_FlickerRect.x() + qRound((m_FlickerRect.width() - pixmap.width()) * 0.5), m_FlickerRect.y() + qRound((m_FlickerRect.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, m_FlickerRect, pixmap);
   }
 
   painter.setClipping(false);
@@ -292,14 +299,17 @@ ToyFlickerWidget::ToyFlickerWidget(QWidget *parent)
 {
   m_HelpText = tr("Flicker between Min and Max\n\nRandomize Timing:\nMin2=Min Timing Scale\nMax2=Max Timing Scale\n\nOSC Trigger:\nNo Arguments = Play\nArgument(0) = Pause\nArgument(1) = Play");
 
-  m_Min = "0";
-  m_Max = "1";
-  m_Min2 = m_Max2 = QString();
+  ToyWidget::SetMin("0");
+  ToyWidget::SetMax("1");
+  ToyWidget::SetMin2(QString());
+  ToyWidget::SetMax2(QString());
 
   m_Widget = new FadeFlicker(this);
-  connect(m_Widget, SIGNAL(valueChanged(float)), this, SLOT(onValueChanged(float)));
+  connect(m_Widget, SIGNAL(pausedChanged()), this, SIGNAL(runningChanged()));
+
+  ToyWidget::SetBPM(QString::number(static_cast<FadeFlicker *>(m_Widget)->GetBPM()));
 
-  m_BPM = QString::number(static_cast<FadeFlicker *>(m_Widget)->GetBPM());
+  UpdateGeneratorOutput();
 
   QPalette pal(m_Widget->palette());
   m_Color = pal.color(QPalette::Button);
@@ -344,6 +354,65 @@ void ToyFlickerWidget::SetTextColor(const QColor &textColor)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyFlickerWidget::SetPath(const QString &path)
+{
+  ToyWidget::SetPath(path);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerWidget::SetMin(const QString &n)
+{
+  ToyWidget::SetMin(n);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerWidget::SetMax(const QString &n)
+{
+  ToyWidget::SetMax(n);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerWidget::UpdateGeneratorOutput()
+{
+  GeneratorThread::sOutput output;
+
+  if (!m_Path.isEmpty())
+  {
+    output.enabled = true;
+    output.floatCount = 1;
+
+    if (m_MinValue.isEmpty)
+    {
+      if (m_MaxValue.isEmpty)
+        output.floatCount = 0;
+      else
+        output.min = output.max = m_MaxValue.value;
+    }
+    else if (m_MaxValue.isEmpty)
+    {
+      output.min = output.max = m_MinValue.value;
+    }
+    else
+    {
+      output.min = m_MinValue.value;
+      output.max = m_MaxValue.value;
+    }
+
+    output.packetTemplate = GetPathTemplate(output.floatCount);
+    output.local = output.packetTemplate.GetLocal();
+  }
+
+  GEN.SetOutput(static_cast<FadeFlicker *>(m_Widget)->GetGeneratorId(), output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyFlickerWidget::SetMin2(const QString &n)
 {
   ToyWidget::SetMin2(n);
@@ -365,19 +434,19 @@ void ToyFlickerWidget::UpdateTimeScaleRange()
   float minValue = 0;
   float maxValue = 0;
 
-  if (m_Min2.isEmpty())
+  if (m_Min2Value.isEmpty)
   {
-    if (!m_Max2.isEmpty())
-      minValue = maxValue = m_Max2.toFloat();
+    if (!m_Max2Value.isEmpty)
+      minValue = maxValue = m_Max2Value.value;
   }
-  else if (m_Max2.isEmpty())
+  else if (m_Max2Value.isEmpty)
   {
-    minValue = maxValue = m_Min2.toFloat();
+    minValue = maxValue = m_Min2Value.value;
   }
   else
   {
-    minValue = m_Min2.toFloat();
-    maxValue = m_Max2.toFloat();
+    minValue = m_Min2Value.value;
+    maxValue = m_Max2Value.value;
   }
 
   static_cast<FadeFlicker *>(m_Widget)->SetTimeScaleRange(minValue, maxValue);
@@ -388,7 +457,16 @@ void ToyFlickerWidget::UpdateTimeScaleRange()
 void ToyFlickerWidget::SetBPM(const QString &bpm)
 {
   ToyWidget::SetBPM(bpm);
-  static_cast<FadeFlicker *>(m_Widget)->SetBPM(m_BPM.toFloat());
+  static_cast<FadeFlicker *>(m_Widget)->SetBPM(m_BPMValue.value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerWidget::SetClock(const QString &clock)
+{
+  ToyWidget::SetClock(clock);
+  static_cast<FadeFlicker *>(m_Widget)->SetClock(m_Clock);
+  emit runningChanged();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -436,19 +514,9 @@ void ToyFlickerWidget::Update(unsigned int ms)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToyFlickerWidget::onValueChanged(float value)
-{
-  emit valueChanged(this, value);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 ToyFlickerGrid::ToyFlickerGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags)
   : ToyGrid(TOY_FLICKER_GRID, pClient, parent, flags)
 {
-  m_Timer = new QTimer(this);
-  connect(m_Timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
-
   m_Play = new FadeButton(this);
   m_Play->setText(tr("Play All"));
   m_Play->resize(m_Play->sizeHint());
@@ -463,26 +531,79 @@ ToyFlickerGrid::ToyFlickerGrid(Client *pClient, QWidget *parent, Qt::WindowFlags
 
 ////////////////////////////////////////////////////////////////////////////////
 
+ToyFlickerGrid::~ToyFlickerGrid()
+{
+  StopTimer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ToyWidget *ToyFlickerGrid::CreateWidget()
 {
-  ToyFlickerWidget *w = new ToyFlickerWidget(this);
-  connect(w, SIGNAL(valueChanged(ToyFlickerWidget *, float)), this, SLOT(onValueChanged(ToyFlickerWidget *, float)));
-  return w;
+  return (new ToyFlickerWidget(this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToyFlickerGrid::StartTimer()
 {
-  m_ElapsedTimer.Start();
-  m_Timer->start(Toy::GetFlickerRefreshRateMS());
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    GEN.SetInterval(static_cast<ToyFlickerWidget *>(*i)->GetFlicker().GetGeneratorId(), Toy::GetFlickerRefreshRateMS());
+
+  QString name;
+  Toy::GetName(m_Type, name);
+  FS.Subscribe(*this, name, Toy::GetVisualIntervalMS(*this, Toy::GetFlickerVisualRateMS()), /*active*/ false);
+  UpdateVisuals();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerGrid::UpdateVisuals()
+{
+  unsigned int intervalMS = GetVisualsIntervalMS(Toy::GetFlickerVisualRateMS());
+  if (intervalMS != 0)
+    FS.SetInterval(*this, intervalMS);
+  FS.SetActive(*this, intervalMS != 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToyFlickerGrid::StopTimer()
 {
-  m_Timer->stop();
+  FS.Unsubscribe(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerGrid::SetGridSize(const QSize &gridSize)
+{
+  ToyGrid::SetGridSize(gridSize);
+  UpdateVisuals();
+  UpdateSeeds();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerGrid::SetSeed(const QString &seed)
+{
+  ToyGrid::SetSeed(seed);
+  UpdateSeeds();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyFlickerGrid::UpdateSeeds()
+{
+  bool seeded = !m_Seed.isEmpty();
+
+  bool ok = false;
+  quint32 seed = m_Seed.toUInt(&ok);
+  if (!ok)
+    seed = static_cast<quint32>(qHash(m_Seed));
+
+  // each widget gets its own stream from the toy seed
+  for (size_t i = 0; i < m_List.size(); i++)
+    static_cast<ToyFlickerWidget *>(m_List[i])->GetFlicker().SetSeed(seeded, seed + static_cast<quint32>(i));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -552,44 +673,8 @@ void ToyFlickerGrid::AutoSize(const QSize &widgetSize)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToyFlickerGrid::onValueChanged(ToyFlickerWidget *flicker, float value)
-{
-  if (m_pClient && flicker && !flicker->GetPath().isEmpty())
-  {
-    QString path(flicker->GetPath());
-    bool local = Utils::MakeLocalOSCPath(false, path);
-
-    OSCPacketWriter packetWriter(path.toUtf8().constData());
-
-    if (flicker->GetMin().isEmpty())
-    {
-      if (!flicker->GetMax().isEmpty())
-        packetWriter.AddFloat32(flicker->GetMax().toFloat());
-    }
-    else if (flicker->GetMax().isEmpty())
-    {
-      packetWriter.AddFloat32(flicker->GetMin().toFloat());
-    }
-    else
-    {
-      float minValue = flicker->GetMin().toFloat();
-      float maxValue = flicker->GetMax().toFloat();
-      value = (minValue + (maxValue - minValue) * value);
-      packetWriter.AddFloat32(value);
-    }
-
-    size_t size;
-    char *packet = packetWriter.Create(size);
-    if (packet)
-      m_pClient->ToyClient_Send(local, packet, size);
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void ToyFlickerGrid::onTimeout()
+void ToyFlickerGrid::FrameSchedulerClient_Tick(unsigned int ms)
 {
-  unsigned int ms = m_ElapsedTimer.Restart();
   for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
     static_cast<ToyFlickerWidget *>(*i)->Update(ms);
 }
@@ -26,6 +26,10 @@
 #include "ToyButton.h"
 #endif
 
+#ifndef GENERATOR_THREAD_H
+#include "GeneratorThread.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class FadeFlicker : public FadeButton
@@ -34,7 +38,9 @@ class FadeFlicker : public FadeButton
 
 public:
   FadeFlicker(QWidget *parent);
+  virtual ~FadeFlicker();
 
+  virtual GeneratorThread::ID GetGeneratorId() const { return m_GeneratorId; }
   virtual void SetText(const QString &text);
   virtual void SetLabel(const QString &label);
   virtual void Update(unsigned int ms);
@@ -44,11 +50,11 @@ public:
   virtual void SetBPM(float bpm);
   virtual bool GetPaused() const { return m_Paused; }
   virtual void SetPaused(bool b);
-
-  static unsigned int GetMsPerBeat(float bpm, float timeScale);
+  virtual void SetClock(const QString &clock);
+  virtual void SetSeed(bool seeded, quint32 seed);
 
 signals:
-  void valueChanged(float value);
+  void pausedChanged();
 
 private slots:
   void onClicked(bool checked);
@@ -56,19 +62,20 @@ private slots:
 protected:
   int m_TextMargin;
   int m_LabelMargin;
+  GeneratorThread::ID m_GeneratorId;
   float m_Value;
   float m_MinTimeScale;
   float m_MaxTimeScale;
   float m_BPM;
-  unsigned int m_MsPerBeat;
-  unsigned int m_Elapsed;
   QRect m_FlickerRect;
   bool m_Paused;
+  bool m_Clocked;
+  bool m_Seeded;
+  quint32 m_Seed;
 
   virtual void UpdateFlickerRect();
   virtual void AutoSizeFont();
   virtual void UpdateMargins();
-  virtual void UpdateMsPerBeat();
   virtual void resizeEvent(QResizeEvent *event);
   virtual void paintEvent(QPaintEvent *event);
 };
@@ -86,55 +93,59 @@ public:
   virtual void SetImagePath(const QString &imagePath);
   virtual void SetColor(const QColor &color);
   virtual void SetTextColor(const QColor &textColor);
+  virtual void SetPath(const QString &path);
+  virtual void SetMin(const QString &n);
+  virtual void SetMax(const QString &n);
   virtual bool HasTriggerPath() const { return true; }
   virtual bool HasMinMax2() const { return true; }
   virtual void SetMin2(const QString &n);
   virtual void SetMax2(const QString &n);
   virtual void SetBPM(const QString &bpm);
   virtual bool HasBPM() const { return true; }
+  virtual void SetClock(const QString &clock);
+  virtual bool HasClock() const { return true; }
+  virtual bool IsRunning() const { return !static_cast<const FadeFlicker *>(m_Widget)->GetPaused(); }
   virtual void SetLabel(const QString &label);
   virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
   virtual void Update(unsigned int ms);
   virtual FadeFlicker &GetFlicker() { return *static_cast<FadeFlicker *>(m_Widget); }
 
-signals:
-  void valueChanged(ToyFlickerWidget *, float value);
-
-private slots:
-  void onValueChanged(float value);
-
 protected:
   virtual void UpdateTimeScaleRange();
+  virtual void UpdateGeneratorOutput();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class ToyFlickerGrid : public ToyGrid
+class ToyFlickerGrid : public ToyGrid, private FrameScheduler::FrameSchedulerClient
 {
   Q_OBJECT
 
 public:
   ToyFlickerGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags);
+  virtual ~ToyFlickerGrid();
 
   virtual void StartTimer();
   virtual void StopTimer();
+  virtual void SetGridSize(const QSize &gridSize);
+  virtual void SetSeed(const QString &seed);
+  virtual bool HasSeed() const { return true; }
 
 private slots:
-  void onValueChanged(ToyFlickerWidget *, float value);
-  void onTimeout();
   void onPlayClicked(bool checked);
   void onPauseClicked(bool checked);
 
 protected:
-  QTimer *m_Timer;
-  EosTimer m_ElapsedTimer;
   FadeButton *m_Play;
   FadeButton *m_Pause;
 
   virtual ToyWidget *CreateWidget();
+  virtual void FrameSchedulerClient_Tick(unsigned int ms);
+  virtual void UpdateVisuals();
   virtual QSize GetDefaultWidgetSize() const { return QSize(80, 120); }
   virtual void UpdateLayout();
   virtual void AutoSize(const QSize &widgetSize);
+  virtual void UpdateSeeds();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
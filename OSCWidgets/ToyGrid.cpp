@@ -151,12 +151,21 @@ ToyGrid::ToyGrid(EnumToyType type, Client *pClient, QWidget *parent, Qt::WindowF
   , m_IgnoreEdits(0)
   , m_pContextMenu(0)
   , m_Loading(false)
+  , m_Shown(false)
+  , m_PaintedCells(false)
+  , m_PressedIndex(0)
   , m_EditPanel(0)
+  , m_LiveResize(false)
 {
   QString name;
   Toy::GetName(m_Type, name);
   SetText(name);
 
+  m_ResizeTimer = new QTimer(this);
+  m_ResizeTimer->setSingleShot(true);
+  m_ResizeTimer->setInterval(RESIZE_SETTLE_MS);
+  connect(m_ResizeTimer, SIGNAL(timeout()), this, SLOT(onResizeSettled()));
+
   SetColor(palette().color(QPalette::Window));
   UpdateImagePath();
 }
@@ -166,6 +175,7 @@ ToyGrid::ToyGrid(EnumToyType type, Client *pClient, QWidget *parent, Qt::WindowF
 ToyGrid::~ToyGrid()
 {
   Clear();
+  ClearCells();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -254,16 +264,23 @@ void ToyGrid::SetGridSize(const QSize &gridSize)
         m_List.push_back(widget);
         ApplyDefaultSettings(widget, m_List.size());
         widget->SetMode(m_Mode);
+        widget->SetPaintedByGrid(m_PaintedCells);
 
-        if (!m_Loading)
+        if (!m_Loading && !m_PaintedCells)
           widget->show();
 
         connect(widget, SIGNAL(edit(ToyWidget *)), this, SLOT(onWidgetEdited(ToyWidget *)));
+        connect(widget, SIGNAL(runningChanged()), this, SLOT(onWidgetRunningChanged()));
+        connect(widget, SIGNAL(cellChanged(ToyWidget *)), this, SLOT(onWidgetCellChanged(ToyWidget *)));
       }
       else
         break;
     }
 
+    m_PressedIndex = m_List.size();
+    if (m_PaintedCells)
+      UpdateCells();
+
     setMinimumSize(m_GridSize.width() * 24, m_GridSize.height() * 24);
 
     m_EditWidgetIndex = m_List.size();
@@ -403,6 +420,12 @@ void ToyGrid::UpdateLayoutForRect(const QRect &r)
     int x = (r.x() + contentsMargins().left());
     int y = (r.y() + contentsMargins().top());
     int col = 0;
+
+    // move every cell, then repaint the grid once
+    bool batch = (isVisible() && updatesEnabled());
+    if (batch)
+      setUpdatesEnabled(false);
+
     for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
     {
       (*i)->setGeometry(x, y, w, h);
@@ -415,6 +438,25 @@ void ToyGrid::UpdateLayoutForRect(const QRect &r)
       else
         x += w;
     }
+
+    if (batch)
+      setUpdatesEnabled(true);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::SetLiveResize(bool b)
+{
+  if (m_LiveResize != b)
+  {
+    m_LiveResize = b;
+
+    for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+      (*i)->SetLiveResize(m_LiveResize);
+
+    if (m_PaintedCells)
+      update();
   }
 }
 
@@ -532,6 +574,30 @@ void ToyGrid::EditWidget(ToyWidget *widget, bool toggle)
       m_EditPanel->SetBPM(QString());
       m_EditPanel->SetBPMEnabled(false);
     }
+    if (widget->HasWaveform())
+    {
+      m_EditPanel->SetWaveform(widget->GetWaveform());
+      m_EditPanel->SetPhase(widget->GetPhase());
+      m_EditPanel->SetDuty(widget->GetDuty());
+      m_EditPanel->SetWaveformEnabled(true);
+    }
+    else
+    {
+      m_EditPanel->SetWaveform(QString());
+      m_EditPanel->SetPhase(QString());
+      m_EditPanel->SetDuty(QString());
+      m_EditPanel->SetWaveformEnabled(false);
+    }
+    if (widget->HasClock())
+    {
+      m_EditPanel->SetClock(widget->GetClock());
+      m_EditPanel->SetClockEnabled(true);
+    }
+    else
+    {
+      m_EditPanel->SetClock(QString());
+      m_EditPanel->SetClockEnabled(false);
+    }
     if (widget->HasVisible())
     {
       m_EditPanel->SetHidden(!widget->GetVisible());
@@ -559,6 +625,12 @@ void ToyGrid::EditWidget(ToyWidget *widget, bool toggle)
     }
     else
       m_EditPanel->SetTextColor2Enabled(false);
+    m_EditPanel->SetSeed(QString());
+    m_EditPanel->SetSeedEnabled(false);
+    m_EditPanel->SetLookahead(QString());
+    m_EditPanel->SetLookaheadEnabled(false);
+    m_EditPanel->SetPaintedCells(false);
+    m_EditPanel->SetPaintedCellsEnabled(false);
     m_EditPanel->SetHelpText(widget->GetHelpText());
   }
   else
@@ -585,6 +657,34 @@ void ToyGrid::EditWidget(ToyWidget *widget, bool toggle)
     m_EditPanel->SetMinMax2Enabled(false);
     m_EditPanel->SetBPM(QString());
     m_EditPanel->SetBPMEnabled(false);
+    m_EditPanel->SetWaveform(QString());
+    m_EditPanel->SetPhase(QString());
+    m_EditPanel->SetDuty(QString());
+    m_EditPanel->SetWaveformEnabled(false);
+    m_EditPanel->SetClock(QString());
+    m_EditPanel->SetClockEnabled(false);
+    if (HasSeed())
+    {
+      m_EditPanel->SetSeed(m_Seed);
+      m_EditPanel->SetSeedEnabled(true);
+    }
+    else
+    {
+      m_EditPanel->SetSeed(QString());
+      m_EditPanel->SetSeedEnabled(false);
+    }
+    if (HasLookahead())
+    {
+      m_EditPanel->SetLookahead(m_Lookahead);
+      m_EditPanel->SetLookaheadEnabled(true);
+    }
+    else
+    {
+      m_EditPanel->SetLookahead(QString());
+      m_EditPanel->SetLookaheadEnabled(false);
+    }
+    m_EditPanel->SetPaintedCells(m_PaintedCells);
+    m_EditPanel->SetPaintedCellsEnabled(HasPaintedCells());
     m_EditPanel->SetColor(m_Color);
     if (HasColor2())
     {
@@ -642,16 +742,27 @@ void ToyGrid::AddRecvWidgets(RECV_WIDGETS &recvWidgets) const
   {
     ToyWidget *w = *i;
     if (!w->GetLabelPath().isEmpty())
-      recvWidgets.insert(RECV_WIDGETS_PAIR(w->GetLabelPath(), w));
+      recvWidgets.insert(RECV_WIDGETS_PAIR(w->GetLabelPathId(), w));
     if (w->HasFeedbackPath() && !w->GetFeedbackPath().isEmpty())
-      recvWidgets.insert(RECV_WIDGETS_PAIR(w->GetFeedbackPath(), w));
+      recvWidgets.insert(RECV_WIDGETS_PAIR(w->GetFeedbackPathId(), w));
     if (w->HasTriggerPath() && !w->GetTriggerPath().isEmpty())
-      recvWidgets.insert(RECV_WIDGETS_PAIR(w->GetTriggerPath(), w));
+      recvWidgets.insert(RECV_WIDGETS_PAIR(w->GetTriggerPathId(), w));
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyGrid::AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const
+{
+  if (!m_ImagePath.isEmpty())
+    prefetch.paths.push_back(m_ImagePath);
+
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    (*i)->AddImagePrefetch(prefetch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool ToyGrid::Save(EosLog &log, const QString &path, QStringList &lines)
 {
   QRect r(frameGeometry().topLeft(), size());
@@ -674,6 +785,9 @@ bool ToyGrid::Save(EosLog &log, const QString &path, QStringList &lines)
   line.append(QString(", %1").arg(Utils::QuotedString(imagePath)));
   line.append(QString(", %1").arg(m_Color.rgba(), 0, 16));
   line.append(QString(", %1").arg(static_cast<int>(m_SendOnConnect ? 1 : 0)));
+  line.append(QString(", %1").arg(Utils::QuotedString(m_Seed)));
+  line.append(QString(", %1").arg(m_Lookahead));
+  line.append(QString(", %1").arg(static_cast<int>(m_PaintedCells ? 1 : 0)));
 
   lines << line;
 
@@ -699,6 +813,11 @@ bool ToyGrid::Load(EosLog &log, const QString &path, QStringList &lines, int &in
     {
       gridSize.setWidth(items[7].toInt());
       gridSize.setHeight(items[8].toInt());
+
+      // before the grid is sized, so painted cells are never shown
+      if (HasPaintedCells() && items.size() > 15)
+        SetPaintedCells(items[15].toInt() != 0);
+
       SetGridSize(gridSize);
       setGeometry(items[1].toInt(), items[2].toInt(), items[3].toInt(), items[4].toInt());
 
@@ -718,6 +837,12 @@ bool ToyGrid::Load(EosLog &log, const QString &path, QStringList &lines, int &in
       if (items.size() > 12)
         SetSendOnConnect(items[12].toInt() != 0);
 
+      if (HasSeed() && items.size() > 13)
+        SetSeed(items[13]);
+
+      if (HasLookahead() && items.size() > 14)
+        SetLookahead(items[14]);
+
       int numToyWidgets = (gridSize.width() * gridSize.height());
       for (int i = 0; i < numToyWidgets && index < lines.size(); i++)
       {
@@ -881,11 +1006,316 @@ void ToyGrid::EditPanelClient_Deleted(EditPanel * /*editPanel*/)
 void ToyGrid::resizeEvent(QResizeEvent *event)
 {
   Toy::resizeEvent(event);
+
+  // another resize before the last one settled means an edge is being dragged,
+  // so cells take the cheap path until onResizeSettled
+  if (m_ResizeTimer->isActive())
+    SetLiveResize(true);
+  m_ResizeTimer->start();
+
   UpdateLayout();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyGrid::onResizeSettled()
+{
+  SetLiveResize(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::showEvent(QShowEvent *event)
+{
+  Toy::showEvent(event);
+  m_Shown = true;
+  UpdateVisuals();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::hideEvent(QHideEvent *event)
+{
+  // also sent when minimized, or when the tab holding this toy is hidden
+  Toy::hideEvent(event);
+  m_Shown = false;
+  UpdateVisuals();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int ToyGrid::GetVisualsIntervalMS(unsigned int visualMS) const
+{
+  // output runs on the generator thread, so nothing needs redrawing while hidden or paused;
+  // paused clocked widgets are polled slowly in case their group is started elsewhere
+  if (!m_Shown)
+    return 0;
+
+  bool clocked = false;
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+  {
+    if ((*i)->IsRunning())
+      return Toy::GetVisualIntervalMS(*this, visualMS);
+
+    if ((*i)->IsClocked())
+      clocked = true;
+  }
+
+  return (clocked ? CLOCK_POLL_MS : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::SetPaintedCells(bool b)
+{
+  if (m_PaintedCells != b)
+  {
+    m_PaintedCells = b;
+    UpdatePaintedCells();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::UpdatePaintedCells()
+{
+  m_PressedIndex = m_List.size();
+
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    (*i)->SetPaintedByGrid(m_PaintedCells);
+
+  if (m_PaintedCells)
+  {
+    connect(&PMC, SIGNAL(ready(const QString &)), this, SLOT(onImageReady(const QString &)), Qt::UniqueConnection);
+    UpdateCells();
+  }
+  else
+  {
+    disconnect(&PMC, SIGNAL(ready(const QString &)), this, SLOT(onImageReady(const QString &)));
+    ClearCells();
+  }
+
+  update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::UpdateCells()
+{
+  while (m_Cells.size() > m_List.size())
+  {
+    PMC.Destroy(m_Cells.back().state.imagePath);
+    m_Cells.pop_back();
+  }
+
+  m_Cells.resize(m_List.size());
+
+  for (size_t i = 0; i < m_Cells.size(); i++)
+    UpdateCell(i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::UpdateCell(size_t index)
+{
+  if (index < m_Cells.size() && index < m_List.size())
+  {
+    sPaintedCell &cell = m_Cells[index];
+    QString imagePath(cell.state.imagePath);
+    m_List[index]->GetCell(cell.state);
+
+    // cells hold their own image references, since their widgets hold none
+    if (imagePath != cell.state.imagePath)
+    {
+      PMC.Destroy(imagePath);
+      PMC.Create(cell.state.imagePath);
+      cell.image = QPixmap();
+      cell.imageSize = QSize();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::ClearCells()
+{
+  for (CELL_LIST::const_iterator i = m_Cells.begin(); i != m_Cells.end(); i++)
+    PMC.Destroy(i->state.imagePath);
+
+  m_Cells.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::PaintCell(QPainter &painter, const QRect &r, sPaintedCell &cell)
+{
+  // same look as an idle FadeButton, without hover or click fades
+  const ToyWidget::sCell &state = cell.state;
+  QRect buttonRect(r.adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN));
+  QRectF rf(buttonRect.adjusted(1, 1, -1, -1));
+
+  QColor color(state.color);
+  if (state.down)
+  {
+    color.setRedF(qMin(color.redF() + BUTTON_BRIGHTESS, 1.0f));
+    color.setGreenF(qMin(color.greenF() + BUTTON_BRIGHTESS, 1.0f));
+    color.setBlueF(qMin(color.blueF() + BUTTON_BRIGHTESS, 1.0f));
+  }
+
+  painter.setPen(Qt::NoPen);
+  painter.setBrush(color);
+  painter.drawRoundedRect(rf, ROUNDED, ROUNDED);
+
+  if (!state.imagePath.isEmpty())
+  {
+    // left unresolved while pending, onImageReady repaints the cell; during a live
+    // resize the previous size is stretched instead, and scaled properly once settled
+    if (!m_LiveResize && cell.imageSize != buttonRect.size() && PMC.GetScaledToFill(state.imagePath, buttonRect.size(), devicePixelRatioF(), cell.image))
+      cell.imageSize = buttonRect.size();
+
+    bool stretch = (m_LiveResize && !cell.image.isNull() && cell.imageSize != buttonRect.size());
+    if (cell.imageSize != buttonRect.size() && !stretch)
+    {
+      QColor placeholder(state.textColor);
+      placeholder.setAlpha(24);
+      painter.setBrush(QBrush(placeholder, Qt::BDiagPattern));
+      painter.drawRoundedRect(rf, ROUNDED, ROUNDED);
+    }
+    else if (!cell.image.isNull())
+    {
+      painter.save();
+      painter.setClipRect(rf);
+      painter.setOpacity(state.down ? 0.5 : 1.0);
+      if (stretch)
+      {
+        QRectF target(QPointF(0, 0), QSizeF(PixmapCache::GetFillSize(cell.image.deviceIndependentSize().toSize(), buttonRect.size())));
+        target.moveCenter(rf.center());
+        painter.drawPixmap(target, cell.image, QRectF(cell.image.rect()));
+      }
+      else
+        FadeButton::DrawCenteredPixmap(painter, rf, cell.image);
+      painter.restore();
+    }
+  }
+
+  bool hasText = !state.text.isEmpty();
+  bool hasLabel = !state.label.isEmpty();
+  if (hasText || hasLabel)
+  {
+    painter.setPen(state.textColor);
+
+    int flags = (Qt::AlignCenter | Qt::TextWordWrap);
+    if (hasText && hasLabel)
+    {
+      QRectF textRect(rf);
+      textRect.setHeight(rf.height() * 0.5);
+      painter.drawText(textRect, flags, state.text);
+      textRect.moveTop(textRect.bottom());
+      painter.drawText(textRect, flags, state.label);
+    }
+    else
+      painter.drawText(rf, flags, hasText ? state.text : state.label);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ToyGrid::event(QEvent *event)
+{
+  if (m_PaintedCells && event->type() == QEvent::ToolTip)
+  {
+    QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
+    size_t index = ToyWidgetIndexAt(helpEvent->pos());
+    if (index < m_List.size() && !m_List[index]->toolTip().isEmpty())
+      QToolTip::showText(helpEvent->globalPos(), m_List[index]->toolTip(), this, m_List[index]->geometry());
+    else
+      QToolTip::hideText();
+    return true;
+  }
+
+  return Toy::event(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::paintEvent(QPaintEvent *event)
+{
+  Toy::paintEvent(event);
+
+  if (!m_PaintedCells || m_Cells.empty())
+    return;
+
+  QPainter painter(this);
+  painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+
+  // every cell is the same size, so they share one font, sized like FadeButton::AutoSizeFont
+  if (!m_List.empty())
+  {
+    QFont fnt(font());
+    QSize cellSize(m_List.front()->size());
+    fnt.setPixelSize(qMax(14, qRound(qMin(cellSize.width() - MARGIN2, cellSize.height() - MARGIN2) * 0.2)));
+    painter.setFont(fnt);
+  }
+
+  for (size_t i = 0; i < m_Cells.size() && i < m_List.size(); i++)
+  {
+    const ToyWidget *widget = m_List[i];
+    if (widget->isVisible())
+      continue;  // selected for editing, drawn by its own widget
+
+    sPaintedCell &cell = m_Cells[i];
+    if (!cell.state.visible && m_Mode != ToyWidget::MODE_EDIT)
+      continue;
+
+    QRect r(widget->geometry());
+    if (event->rect().intersects(r))
+      PaintCell(painter, r, cell);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::mousePressEvent(QMouseEvent *event)
+{
+  if (m_PaintedCells && event->button() == Qt::LeftButton)
+  {
+    size_t index = ToyWidgetIndexAt(event->pos());
+    if (index < m_List.size())
+    {
+      if (m_Mode == ToyWidget::MODE_EDIT)
+        EditWidget(m_List[index], /*toggle*/ true);
+      else if (m_List[index]->GetVisible())
+      {
+        m_PressedIndex = index;
+        m_List[index]->PressCell();
+      }
+
+      event->accept();
+      return;
+    }
+  }
+
+  Toy::mousePressEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::mouseReleaseEvent(QMouseEvent *event)
+{
+  if (m_PressedIndex < m_List.size() && event->button() == Qt::LeftButton)
+  {
+    size_t index = m_PressedIndex;
+    m_PressedIndex = m_List.size();
+    m_List[index]->ReleaseCell();
+    event->accept();
+    return;
+  }
+
+  Toy::mouseReleaseEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyGrid::contextMenuEvent(QContextMenuEvent *event)
 {
   QString name;
@@ -1031,6 +1461,42 @@ void ToyGrid::onWidgetEdited(ToyWidget *widget)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyGrid::onWidgetRunningChanged()
+{
+  UpdateVisuals();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::onWidgetCellChanged(ToyWidget *widget)
+{
+  for (size_t i = 0; i < m_List.size(); i++)
+  {
+    if (m_List[i] == widget)
+    {
+      UpdateCell(i);
+      update(widget->geometry());
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyGrid::onImageReady(const QString &path)
+{
+  for (size_t i = 0; i < m_Cells.size() && i < m_List.size(); i++)
+  {
+    if (m_Cells[i].state.imagePath == path)
+    {
+      m_Cells[i].imageSize = QSize();
+      update(m_List[i]->geometry());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyGrid::onEdited()
 {
   if (!m_EditPanel || m_IgnoreEdits != 0)
@@ -1122,6 +1588,24 @@ void ToyGrid::onEdited()
       widget->SetBPM(str);
     }
 
+    if (widget->HasWaveform())
+    {
+      m_EditPanel->GetWaveform(str);
+      widget->SetWaveform(str);
+
+      m_EditPanel->GetPhase(str);
+      widget->SetPhase(str);
+
+      m_EditPanel->GetDuty(str);
+      widget->SetDuty(str);
+    }
+
+    if (widget->HasClock())
+    {
+      m_EditPanel->GetClock(str);
+      widget->SetClock(str);
+    }
+
     if (widget->HasVisible())
       widget->SetVisible(!m_EditPanel->GetHidden());
 
@@ -1174,6 +1658,21 @@ void ToyGrid::onEdited()
       m_EditPanel->GetTextColor(color);
       SetTextColor(color);
     }
+
+    if (HasSeed())
+    {
+      m_EditPanel->GetSeed(str);
+      SetSeed(str);
+    }
+
+    if (HasLookahead())
+    {
+      m_EditPanel->GetLookahead(str);
+      SetLookahead(str);
+    }
+
+    if (HasPaintedCells())
+      SetPaintedCells(m_EditPanel->GetPaintedCells());
   }
 
   emit changed();
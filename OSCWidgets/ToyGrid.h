@@ -44,6 +44,7 @@
 #define QUICK_GRID_WIDTH 10
 #define QUICK_GRID_HEIGHT 10
 #define QUICK_GRID_TABS 10
+#define CLOCK_POLL_MS 250
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -100,6 +101,11 @@ class ToyGrid : public Toy, private EditPanel::EditPanelClient
   Q_OBJECT
 
 public:
+  enum EnumConstants
+  {
+    RESIZE_SETTLE_MS = 150
+  };
+
   typedef std::vector<ToyWidget *> WIDGET_LIST;
 
   ToyGrid(EnumToyType type, Client *pClient, QWidget *parent, Qt::WindowFlags flags);
@@ -124,9 +130,19 @@ public:
   virtual void SetTextColor(const QColor &textColor);
   virtual bool GetSendOnConnect() const { return m_SendOnConnect; }
   virtual void SetSendOnConnect(bool b) { m_SendOnConnect = b; }
+  virtual const QString &GetSeed() const { return m_Seed; }
+  virtual void SetSeed(const QString &seed) { m_Seed = seed; }
+  virtual bool HasSeed() const { return false; }
+  virtual const QString &GetLookahead() const { return m_Lookahead; }
+  virtual void SetLookahead(const QString &lookahead) { m_Lookahead = lookahead; }
+  virtual bool HasLookahead() const { return false; }
+  virtual bool GetPaintedCells() const { return m_PaintedCells; }
+  virtual void SetPaintedCells(bool b);
+  virtual bool HasPaintedCells() const { return false; }
   virtual const ToyWidget *ToyWidgetAt(const QPoint &pos) const;
   virtual size_t ToyWidgetIndexAt(const QPoint &pos) const;
   virtual void AddRecvWidgets(RECV_WIDGETS &recvWidgets) const;
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const;
   virtual bool Save(EosLog &log, const QString &path, QStringList &lines);
   virtual bool Load(EosLog &log, const QString &path, QStringList &lines, int &index);
   virtual void GetName(QString &name) const;
@@ -147,12 +163,16 @@ private slots:
   void onDeleteConfirm(int result);
   void onToggleMainWindow();
   void onWidgetEdited(ToyWidget *widget);
+  void onWidgetRunningChanged();
+  void onWidgetCellChanged(ToyWidget *widget);
+  void onImageReady(const QString &path);
   void onEdited();
   void onDone();
   void onGridResized(size_t Id, const QSize &size);
   void onTabResized(size_t Id, const QSize &size);
   void onToyAdded(size_t toyType, const QSize &gridSize);
   void onClearLabels();
+  void onResizeSettled();
 
 private:
   virtual void EditPanelClient_Deleted(EditPanel *editPanel);
@@ -160,6 +180,17 @@ private:
 protected:
   typedef std::map<QAction *, EnumToyType> TOY_TYPE_ACTIONS;
 
+  // per-cell state for painted cells, where the grid draws and hit-tests cells instead of their
+  // widgets; the widgets still exist, hidden, and hold each cell's settings
+  struct sPaintedCell
+  {
+    ToyWidget::sCell state;
+    QPixmap image;
+    QSize imageSize;
+  };
+
+  typedef std::vector<sPaintedCell> CELL_LIST;
+
   ToyWidget::EnumMode m_Mode;
   QSize m_GridSize;
   WIDGET_LIST m_List;
@@ -169,15 +200,24 @@ protected:
   QString m_ImagePath;
   QColor m_Color;
   bool m_SendOnConnect;
+  QString m_Seed;
+  QString m_Lookahead;
   size_t m_EditWidgetIndex;
   QMenu *m_pContextMenu;
   bool m_Loading;
+  bool m_Shown;
+  bool m_PaintedCells;
+  CELL_LIST m_Cells;
+  size_t m_PressedIndex;
+  QTimer *m_ResizeTimer;
+  bool m_LiveResize;
 
   virtual ToyWidget *CreateWidget() { return 0; }
   virtual QSize GetDefaultWidgetSize() const { return QSize(80, 80); }
   virtual void UpdateMode();
   virtual void UpdateLayout();
   virtual void UpdateLayoutForRect(const QRect &r);
+  virtual void SetLiveResize(bool b);
   virtual void UpdateText();
   virtual void UpdateImagePath();
   virtual void UpdateColor();
@@ -187,7 +227,20 @@ protected:
   virtual void CreateEditPanel();
   virtual void CloseEditPanel();
   virtual void HandleGridResize(bool tab, const QSize &size);
+  virtual void UpdateVisuals() {}
+  virtual unsigned int GetVisualsIntervalMS(unsigned int visualMS) const;
+  virtual void UpdatePaintedCells();
+  virtual void UpdateCells();
+  virtual void UpdateCell(size_t index);
+  virtual void ClearCells();
+  virtual void PaintCell(QPainter &painter, const QRect &r, sPaintedCell &cell);
+  virtual bool event(QEvent *event);
+  virtual void paintEvent(QPaintEvent *event);
+  virtual void mousePressEvent(QMouseEvent *event);
+  virtual void mouseReleaseEvent(QMouseEvent *event);
   virtual void resizeEvent(QResizeEvent *event);
+  virtual void showEvent(QShowEvent *event);
+  virtual void hideEvent(QHideEvent *event);
   virtual void contextMenuEvent(QContextMenuEvent *event);
   virtual void closeEvent(QCloseEvent *event);
 };
@@ -51,42 +51,14 @@ void FadeLabel::paintEvent(QPaintEvent * /*event*/)
   sImage &img = m_Images[m_ImageIndex];
   if (!img.pixmap.isNull())
   {
-    painter.drawPixmap(r.x() + qRound((r.width() - img.pixmap.width()) * 0.5), r.y() + qRound((r.height() - img.pixmap.height()) * 0.5), img.pixmap);
+    DrawCenteredPixmap(painter, r, img.pixmap);
   }
 
   QColor textColor(palette().color(QPalette::ButtonText));
   if (!isEnabled())
     textColor = textColor.darker(150);
 
-  if (!text().isEmpty())
-  {
-    if (m_Label.isEmpty())
-    {
-      // just text centered
-      painter.setPen(textColor);
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap, text());
-    }
-    else
-    {
-      // both text and label text
-      QRectF textRect;
-      painter.setPen(textColor);
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap | Qt::TextDontPrint, text(), &textRect);
-
-      QRectF labelRect;
-      painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap | Qt::TextDontPrint, m_Label, &labelRect);
-
-      qreal h = (r.height() * 0.5 * (textRect.height() / labelRect.height()));
-      painter.drawText(QRectF(r.x(), r.y(), r.width(), h), Qt::AlignCenter | Qt::TextWordWrap, text());
-      painter.drawText(QRectF(r.x(), r.y() + h, r.width(), r.height() - h), Qt::AlignCenter | Qt::TextWordWrap, m_Label);
-    }
-  }
-  else if (!m_Label.isEmpty())
-  {
-    // just label text centered
-    painter.setPen(textColor);
-    painter.drawText(r, Qt::AlignCenter | Qt::TextWordWrap, m_Label);
-  }
+  RenderText(painter, r, textColor);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,6 +146,21 @@ void ToyLabelWidget::ClearLabel()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyLabelWidget::AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const
+{
+  ToyWidget::AddImagePrefetch(prefetch);
+
+  // a trigger swaps in an image at this label's size, likely from beside its own
+  if (m_Widget && !m_TriggerPath.isEmpty())
+  {
+    PixmapCache::AddPrefetchSize(m_Widget->size(), m_Widget->devicePixelRatioF(), prefetch.sizes);
+    if (!m_ImagePath.isEmpty())
+      prefetch.triggerPaths.push_back(m_ImagePath);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyLabelWidget::Recv(const QString &path, const OSCArgument *args, size_t count)
 {
   QString str;
@@ -57,6 +57,7 @@ public:
   virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
   virtual void SetLabel(const QString &label);
   virtual void ClearLabel();
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const;
   virtual bool HasPath() const { return false; }
   virtual bool HasMinMax() const { return false; }
   virtual bool HasFeedbackPath() const { return false; }
@@ -24,6 +24,7 @@
 
 #define _USE_MATH_DEFINES 1
 #include <math.h>
+#include <stdint.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -32,4 +33,47 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// xoshiro128**, small and fast enough to give every generator its own stream
+class FastRandom
+{
+public:
+  FastRandom(uint32_t seed = 0) { Seed(seed); }
+
+  void Seed(uint32_t seed)
+  {
+    // splitmix32 expands the seed so nearby seeds give unrelated streams
+    for (int i = 0; i < 4; i++)
+    {
+      seed += 0x9e3779b9;
+      uint32_t z = seed;
+      z = ((z ^ (z >> 16)) * 0x85ebca6b);
+      z = ((z ^ (z >> 13)) * 0xc2b2ae35);
+      m_State[i] = (z ^ (z >> 16));
+    }
+  }
+
+  uint32_t Next()
+  {
+    uint32_t result = (Rotl(m_State[1] * 5, 7) * 9);
+    uint32_t t = (m_State[1] << 9);
+    m_State[2] ^= m_State[0];
+    m_State[3] ^= m_State[1];
+    m_State[1] ^= m_State[2];
+    m_State[0] ^= m_State[3];
+    m_State[2] ^= t;
+    m_State[3] = Rotl(m_State[3], 11);
+    return result;
+  }
+
+  // 0..1, exclusive of 1
+  float NextFloat() { return ((Next() >> 8) * (1.0f / 16777216.0f)); }
+
+private:
+  uint32_t m_State[4];
+
+  static uint32_t Rotl(uint32_t x, int k) { return ((x << k) | (x >> (32 - k))); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 #endif
@@ -34,9 +34,19 @@ FadeMetro::FadeMetro(QWidget *parent)
   , m_BPM(60)
   , m_ArmLength(0)
   , m_Paused(true)
+  , m_Clocked(false)
 {
   connect(this, SIGNAL(clicked(bool)), this, SLOT(onClicked(bool)));
-  UpdateSpeed();
+
+  m_GeneratorId = GEN.Add(GeneratorThread::GENERATOR_METRO, Toy::GetMetroRefreshRateMS());
+  GEN.SetBPM(m_GeneratorId, m_BPM);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FadeMetro::~FadeMetro()
+{
+  GEN.Remove(m_GeneratorId);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -44,10 +54,20 @@ FadeMetro::FadeMetro(QWidget *parent)
 void FadeMetro::ReCenter()
 {
   m_Pos = 0;
+  GEN.SetPos(m_GeneratorId, m_Pos);
 
   if (!m_Paused)
-    emit tick(TICK_POS_CENTER);
+    GEN.Trigger(m_GeneratorId, GeneratorThread::METRO_TICK_CENTER);
+
+  update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void FadeMetro::SetPos(float pos)
+{
+  m_Pos = pos;
+  GEN.SetPos(m_GeneratorId, m_Pos);
   update();
 }
 
@@ -119,7 +139,7 @@ void FadeMetro::SetBPM(float bpm)
   if (m_BPM != bpm)
   {
     m_BPM = bpm;
-    UpdateSpeed();
+    GEN.SetBPM(m_GeneratorId, m_BPM);
   }
 }
 
@@ -130,20 +150,22 @@ void FadeMetro::SetPaused(bool b)
   if (m_Paused != b)
   {
     m_Paused = b;
+    GEN.SetPaused(m_GeneratorId, m_Paused);
 
     if (!m_Paused && GetTickPos() == TICK_POS_CENTER)
-      emit tick(TICK_POS_CENTER);
+      GEN.Trigger(m_GeneratorId, GeneratorThread::METRO_TICK_CENTER);
 
     update();
+    emit pausedChanged();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeMetro::UpdateSpeed()
+void FadeMetro::SetClock(const QString &clock)
 {
-  float beatsPerMillisecond = (m_BPM / 60000);
-  m_Speed = (beatsPerMillisecond * M_PI);
+  m_Clocked = !clock.isEmpty();
+  GEN.SetClock(m_GeneratorId, clock);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,7 +179,7 @@ int FadeMetro::GetSegment() const
 
 int FadeMetro::GetSegmentForPos(float pos) const
 {
-  return (pos / TWO_PI * 3.99999);
+  return GeneratorThread::GetMetroSegment(pos);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,31 +193,30 @@ FadeMetro::EnumTickPos FadeMetro::GetTickPos() const
 
 FadeMetro::EnumTickPos FadeMetro::GetTickPosForSegment(int segment) const
 {
-  switch (segment)
-  {
-    case 1: return TICK_POS_RIGHT;
-    case 3: return TICK_POS_LEFT;
-  }
-
-  return TICK_POS_CENTER;
+  return static_cast<EnumTickPos>(GeneratorThread::GetMetroTickForSegment(segment));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeMetro::Update(unsigned int ms)
+void FadeMetro::Update(unsigned int /*ms*/)
 {
-  if (!m_Paused && ms != 0)
+  // the generator thread owns the phase and sends ticks, just follow it for drawing
+  GeneratorThread::sState state;
+  if ((!m_Paused || m_Clocked) && GEN.GetState(m_GeneratorId, state))
   {
-    float prevPos = m_Pos;
-    m_Pos = fmod(m_Pos + ms * m_Speed, static_cast<float>(TWO_PI));
-
-    int prevSegment = GetSegmentForPos(prevPos);
-    int segment = GetSegmentForPos(m_Pos);
-
-    if (segment != prevSegment)
-      emit tick(GetTickPosForSegment(segment));
+    // a clocked widget can also be started or stopped by its group
+    if (m_Paused != state.paused)
+    {
+      m_Paused = state.paused;
+      update();
+      emit pausedChanged();
+    }
 
-    update();
+    if (m_Pos != state.pos)
+    {
+      m_Pos = state.pos;
+      update();
+    }
   }
 }
 
@@ -223,7 +244,7 @@ void FadeMetro::paintEvent(QPaintEvent * /*event*/)
   const QPixmap &pixmap = m_Images[m_ImageIndex].pixmap;
   if (!pixmap.isNull())
   {
-    painter.drawPixmap(m_MetroRect.x() + qRound((m_MetroRect.width() - pixmap.width()) * 0.5), m_MetroRect.y() + qRound((m_MetroRect.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, m_MetroRect, pixmap);
   }
 
   painter.setClipping(false);
@@ -321,13 +342,15 @@ ToyMetroWidget::ToyMetroWidget(QWidget *parent)
 {
   m_HelpText = tr("If Min or Max blank, tick on center\n\nOtherwise, tick at ends\n\nOSC Trigger:\nNo Arguments = Play\nArgument(0) = Pause\nArgument(1) = Play");
 
-  m_Min = QString();
-  m_Max = "1";
+  ToyWidget::SetMin(QString());
+  ToyWidget::SetMax("1");
 
   m_Widget = new FadeMetro(this);
-  connect(m_Widget, SIGNAL(tick(int)), this, SLOT(onTick(int)));
+  connect(m_Widget, SIGNAL(pausedChanged()), this, SIGNAL(runningChanged()));
+
+  ToyWidget::SetBPM(QString::number(static_cast<FadeMetro *>(m_Widget)->GetBPM()));
 
-  m_BPM = QString::number(static_cast<FadeMetro *>(m_Widget)->GetBPM());
+  UpdateGeneratorOutput();
 
   QPalette pal(m_Widget->palette());
   m_Color = pal.color(QPalette::Button);
@@ -372,15 +395,152 @@ void ToyMetroWidget::SetTextColor(const QColor &textColor)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyMetroWidget::SetPath(const QString &path)
+{
+  ToyWidget::SetPath(path);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroWidget::SetMin(const QString &n)
+{
+  ToyWidget::SetMin(n);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroWidget::SetMax(const QString &n)
+{
+  ToyWidget::SetMax(n);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ToyMetroWidget::BuildTickPacket(FadeMetro::EnumTickPos pos, QByteArray &packet) const
+{
+  packet.clear();
+
+  if (m_Path.isEmpty())
+    return false;
+
+  const QString *value = 0;
+  const sValue *numericValue = 0;
+  bool forceStrArg = false;
+
+  if (m_MinValue.isEmpty)
+  {
+    if (pos == FadeMetro::TICK_POS_CENTER)
+    {
+      if (!m_MaxValue.isEmpty)
+      {
+        value = &m_Max;
+        numericValue = &m_MaxValue;
+      }
+    }
+    else
+      return false;
+  }
+  else if (m_MaxValue.isEmpty)
+  {
+    if (pos == FadeMetro::TICK_POS_CENTER)
+    {
+      value = &m_Min;
+      numericValue = &m_MinValue;
+    }
+    else
+      return false;
+  }
+  else if (m_Min == m_Max)
+  {
+    if (pos == FadeMetro::TICK_POS_CENTER)
+    {
+      value = &m_Max;
+      numericValue = &m_MaxValue;
+
+      if (!m_MinValue.isFloat || !m_MaxValue.isFloat)
+        forceStrArg = true;  // if either is non-numeric, send both as strings
+    }
+    else
+      return false;
+  }
+  else if (pos == FadeMetro::TICK_POS_LEFT || pos == FadeMetro::TICK_POS_RIGHT)
+  {
+    bool left = (pos == FadeMetro::TICK_POS_LEFT);
+    value = (left ? &m_Min : &m_Max);
+    numericValue = (left ? &m_MinValue : &m_MaxValue);
+
+    if (!m_MinValue.isFloat || !m_MaxValue.isFloat)
+      forceStrArg = true;  // if either is non-numeric, send both as strings
+  }
+  else
+    return false;
+
+  OSCPacketWriter packetWriter(OAT.Get(m_PathId).utf8.constData());
+
+  if (value && numericValue)
+  {
+    if (!forceStrArg && numericValue->isFloat)
+      packetWriter.AddFloat32(numericValue->value);
+    else
+      packetWriter.AddString(value->toUtf8().constData());
+  }
+
+  size_t size;
+  char *data = packetWriter.Create(size);
+  if (data)
+  {
+    packet = QByteArray(data, static_cast<int>(size));
+    delete[] data;
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroWidget::UpdateGeneratorOutput()
+{
+  // every tick message is fixed for a given path and min/max, so build them up front
+  GeneratorThread::sOutput output;
+
+  if (!m_Path.isEmpty())
+  {
+    output.local = OAT.Get(m_PathId).local;
+
+    for (int i = 0; i < GeneratorThread::METRO_TICK_COUNT; i++)
+    {
+      if (BuildTickPacket(static_cast<FadeMetro::EnumTickPos>(i), output.tickPackets[i]))
+        output.enabled = true;
+    }
+  }
+
+  GEN.SetOutput(static_cast<FadeMetro *>(m_Widget)->GetGeneratorId(), output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyMetroWidget::SetBPM(const QString &bpm)
 {
   ToyWidget::SetBPM(bpm);
-  float n = m_BPM.toFloat();
+  float n = m_BPMValue.value;
   static_cast<FadeMetro *>(m_Widget)->SetBPM(qBound(0.0f, n, 600.0f));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyMetroWidget::SetClock(const QString &clock)
+{
+  ToyWidget::SetClock(clock);
+  static_cast<FadeMetro *>(m_Widget)->SetClock(m_Clock);
+  emit runningChanged();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyMetroWidget::SetLabel(const QString &label)
 {
   static_cast<FadeMetro *>(m_Widget)->SetLabel(label);
@@ -424,19 +584,9 @@ void ToyMetroWidget::Update(unsigned int ms)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToyMetroWidget::onTick(int pos)
-{
-  emit tick(this, pos);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 ToyMetroGrid::ToyMetroGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags)
   : ToyGrid(TOY_METRO_GRID, pClient, parent, flags)
 {
-  m_Timer = new QTimer(this);
-  connect(m_Timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
-
   m_Play = new FadeButton(this);
   m_Play->setText(tr("Play All"));
   m_Play->resize(m_Play->sizeHint());
@@ -459,26 +609,72 @@ ToyMetroGrid::ToyMetroGrid(Client *pClient, QWidget *parent, Qt::WindowFlags fla
 
 ////////////////////////////////////////////////////////////////////////////////
 
+ToyMetroGrid::~ToyMetroGrid()
+{
+  StopTimer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ToyWidget *ToyMetroGrid::CreateWidget()
 {
-  ToyMetroWidget *w = new ToyMetroWidget(this);
-  connect(w, SIGNAL(tick(ToyMetroWidget *, int)), this, SLOT(onTick(ToyMetroWidget *, int)));
-  return w;
+  return (new ToyMetroWidget(this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToyMetroGrid::StartTimer()
 {
-  m_ElapsedTimer.Start();
-  m_Timer->start(Toy::GetMetroRefreshRateMS());
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    GEN.SetInterval(static_cast<ToyMetroWidget *>(*i)->GetMetro().GetGeneratorId(), Toy::GetMetroRefreshRateMS());
+
+  QString name;
+  Toy::GetName(m_Type, name);
+  FS.Subscribe(*this, name, Toy::GetVisualIntervalMS(*this, Toy::GetMetroVisualRateMS()), /*active*/ false);
+  UpdateVisuals();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroGrid::UpdateVisuals()
+{
+  unsigned int intervalMS = GetVisualsIntervalMS(Toy::GetMetroVisualRateMS());
+  if (intervalMS != 0)
+    FS.SetInterval(*this, intervalMS);
+  FS.SetActive(*this, intervalMS != 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToyMetroGrid::StopTimer()
 {
-  m_Timer->stop();
+  FS.Unsubscribe(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroGrid::SetGridSize(const QSize &gridSize)
+{
+  ToyGrid::SetGridSize(gridSize);
+  UpdateVisuals();
+  UpdateLookahead();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroGrid::SetLookahead(const QString &lookahead)
+{
+  ToyGrid::SetLookahead(lookahead);
+  UpdateLookahead();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyMetroGrid::UpdateLookahead()
+{
+  unsigned int lookaheadMS = static_cast<unsigned int>(qBound(0, m_Lookahead.toInt(), 1000));
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    GEN.SetLookahead(static_cast<ToyMetroWidget *>(*i)->GetMetro().GetGeneratorId(), lookaheadMS);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -564,78 +760,8 @@ void ToyMetroGrid::AutoSize(const QSize &widgetSize)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToyMetroGrid::onTick(ToyMetroWidget *metro, int pos)
-{
-  if (m_pClient && metro && !metro->GetPath().isEmpty())
-  {
-    QString value;
-    bool forceStrArg = false;
-
-    if (metro->GetMin().isEmpty())
-    {
-      if (pos == FadeMetro::TICK_POS_CENTER)
-      {
-        if (!metro->GetMax().isEmpty())
-          value = metro->GetMax();
-      }
-      else
-        return;
-    }
-    else if (metro->GetMax().isEmpty())
-    {
-      if (pos == FadeMetro::TICK_POS_CENTER)
-        value = metro->GetMin();
-      else
-        return;
-    }
-    else if (metro->GetMin() == metro->GetMax())
-    {
-      if (pos == FadeMetro::TICK_POS_CENTER)
-      {
-        value = metro->GetMax();
-
-        if (!OSCArgument::IsFloatString(metro->GetMin().toUtf8().constData()) || !OSCArgument::IsFloatString(metro->GetMax().toUtf8().constData()))
-          forceStrArg = true;  // if either is non-numeric, send both as strings
-      }
-      else
-        return;
-    }
-    else if (pos == FadeMetro::TICK_POS_LEFT || pos == FadeMetro::TICK_POS_RIGHT)
-    {
-      value = ((pos == FadeMetro::TICK_POS_LEFT) ? metro->GetMin() : metro->GetMax());
-
-      if (!OSCArgument::IsFloatString(metro->GetMin().toUtf8().constData()) || !OSCArgument::IsFloatString(metro->GetMax().toUtf8().constData()))
-        forceStrArg = true;  // if either is non-numeric, send both as strings
-    }
-    else
-      return;
-
-    QString path(metro->GetPath());
-    bool local = Utils::MakeLocalOSCPath(false, path);
-
-    OSCPacketWriter packetWriter(path.toUtf8().constData());
-
-    if (!value.isEmpty())
-    {
-      QByteArray ba(value.toUtf8());
-      if (!forceStrArg && OSCArgument::IsFloatString(ba.constData()))
-        packetWriter.AddFloat32(value.toFloat());
-      else
-        packetWriter.AddString(ba.constData());
-    }
-
-    size_t size;
-    char *packet = packetWriter.Create(size);
-    if (packet)
-      m_pClient->ToyClient_Send(local, packet, size);
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void ToyMetroGrid::onTimeout()
+void ToyMetroGrid::FrameSchedulerClient_Tick(unsigned int ms)
 {
-  unsigned int ms = m_ElapsedTimer.Restart();
   for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
     static_cast<ToyMetroWidget *>(*i)->Update(ms);
 }
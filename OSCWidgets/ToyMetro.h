@@ -26,6 +26,10 @@
 #include "ToyButton.h"
 #endif
 
+#ifndef GENERATOR_THREAD_H
+#include "GeneratorThread.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class FadeMetro : public FadeButton
@@ -35,20 +39,18 @@ class FadeMetro : public FadeButton
 public:
   enum EnumTickPos
   {
-    TICK_POS_LEFT,
-    TICK_POS_CENTER,
-    TICK_POS_RIGHT
+    TICK_POS_LEFT = GeneratorThread::METRO_TICK_LEFT,
+    TICK_POS_CENTER = GeneratorThread::METRO_TICK_CENTER,
+    TICK_POS_RIGHT = GeneratorThread::METRO_TICK_RIGHT
   };
 
   FadeMetro(QWidget *parent);
+  virtual ~FadeMetro();
 
+  virtual GeneratorThread::ID GetGeneratorId() const { return m_GeneratorId; }
   virtual void ReCenter();
   virtual float GetPos() const { return m_Pos; }
-  virtual void SetPos(float pos)
-  {
-    m_Pos = pos;
-    update();
-  }
+  virtual void SetPos(float pos);
   virtual void SetText(const QString &text);
   virtual void SetLabel(const QString &label);
   virtual void Update(unsigned int ms);
@@ -56,9 +58,10 @@ public:
   virtual void SetBPM(float bpm);
   virtual bool GetPaused() const { return m_Paused; }
   virtual void SetPaused(bool b);
+  virtual void SetClock(const QString &clock);
 
 signals:
-  void tick(int pos);
+  void pausedChanged();
 
 private slots:
   void onClicked(bool checked);
@@ -66,19 +69,19 @@ private slots:
 protected:
   int m_TextMargin;
   int m_LabelMargin;
+  GeneratorThread::ID m_GeneratorId;
   float m_Pos;
-  float m_Speed;
   float m_BPM;
   QRect m_MetroRect;
   float m_ArmLength;
   bool m_Paused;
+  bool m_Clocked;
 
   virtual int GetSegment() const;
   virtual int GetSegmentForPos(float pos) const;
   virtual EnumTickPos GetTickPos() const;
   virtual EnumTickPos GetTickPosForSegment(int segment) const;
   virtual void UpdateMetroRect();
-  virtual void UpdateSpeed();
   virtual void AutoSizeFont();
   virtual void UpdateMargins();
   virtual void resizeEvent(QResizeEvent *event);
@@ -98,53 +101,60 @@ public:
   virtual void SetImagePath(const QString &imagePath);
   virtual void SetColor(const QColor &color);
   virtual void SetTextColor(const QColor &textColor);
+  virtual void SetPath(const QString &path);
+  virtual void SetMin(const QString &n);
+  virtual void SetMax(const QString &n);
   virtual bool HasTriggerPath() const { return true; }
   virtual void SetBPM(const QString &bpm);
   virtual bool HasBPM() const { return true; }
+  virtual void SetClock(const QString &clock);
+  virtual bool HasClock() const { return true; }
+  virtual bool IsRunning() const { return !static_cast<const FadeMetro *>(m_Widget)->GetPaused(); }
   virtual void SetLabel(const QString &label);
   virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
   virtual void Update(unsigned int ms);
   virtual FadeMetro &GetMetro() { return *static_cast<FadeMetro *>(m_Widget); }
 
-signals:
-  void tick(ToyMetroWidget *, int pos);
-
-private slots:
-  void onTick(int pos);
+protected:
+  virtual bool BuildTickPacket(FadeMetro::EnumTickPos pos, QByteArray &packet) const;
+  virtual void UpdateGeneratorOutput();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class ToyMetroGrid : public ToyGrid
+class ToyMetroGrid : public ToyGrid, private FrameScheduler::FrameSchedulerClient
 {
   Q_OBJECT
 
 public:
   ToyMetroGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags);
+  virtual ~ToyMetroGrid();
 
   virtual void StartTimer();
   virtual void StopTimer();
+  virtual void SetGridSize(const QSize &gridSize);
+  virtual void SetLookahead(const QString &lookahead);
+  virtual bool HasLookahead() const { return true; }
 
 private slots:
-  void onTick(ToyMetroWidget *, int pos);
-  void onTimeout();
   void onPlayClicked(bool checked);
   void onPauseClicked(bool checked);
   void onReCenterClicked(bool checked);
   void onFanClicked(bool checked);
 
 protected:
-  QTimer *m_Timer;
-  EosTimer m_ElapsedTimer;
   FadeButton *m_Play;
   FadeButton *m_Pause;
   FadeButton *m_ReCenter;
   FadeButton *m_Fan;
 
   virtual ToyWidget *CreateWidget();
+  virtual void FrameSchedulerClient_Tick(unsigned int ms);
+  virtual void UpdateVisuals();
   virtual QSize GetDefaultWidgetSize() const { return QSize(80, 120); }
   virtual void UpdateLayout();
   virtual void AutoSize(const QSize &widgetSize);
+  virtual void UpdateLookahead();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -197,7 +197,7 @@ void FadePedal::paintEvent(QPaintEvent * /*event*/)
     if (!pixmap.isNull())
     {
       painter.setOpacity(1.0 - (brightness * 0.5));
-      painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+      DrawCenteredPixmap(painter, r, pixmap);
       painter.setOpacity(1.0);
     }
 
@@ -219,7 +219,7 @@ void FadePedal::paintEvent(QPaintEvent * /*event*/)
       clip.addRoundedRect(r, ROUNDED, ROUNDED);
       painter.setClipPath(clip);
 
-      painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+      DrawCenteredPixmap(painter, r, pixmap);
 
       painter.setClipping(false);
     }
@@ -351,8 +351,8 @@ ToyPedalWidget::ToyPedalWidget(QWidget *parent)
 
   FadePedal *pedal = new FadePedal(this);
 
-  m_Min2 = QString::number(pedal->GetUpDuration());
-  m_Max2 = QString::number(pedal->GetDownDuration());
+  ToyWidget::SetMin2(QString::number(pedal->GetUpDuration()));
+  ToyWidget::SetMax2(QString::number(pedal->GetDownDuration()));
 
   m_Widget = pedal;
   connect(m_Widget, SIGNAL(tick(float)), this, SLOT(onTick(float)));
@@ -485,9 +485,6 @@ void ToyPedalWidget::onTick(float value)
 ToyPedalGrid::ToyPedalGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags)
   : ToyGrid(TOY_PEDAL_GRID, pClient, parent, flags)
 {
-  m_Timer = new QTimer(this);
-  connect(m_Timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
-
   m_Press = new FadeButton(this);
   m_Press->setText(tr("Press All"));
   m_Press->resize(m_Press->sizeHint());
@@ -499,6 +496,13 @@ ToyPedalGrid::ToyPedalGrid(Client *pClient, QWidget *parent, Qt::WindowFlags fla
 
 ////////////////////////////////////////////////////////////////////////////////
 
+ToyPedalGrid::~ToyPedalGrid()
+{
+  StopTimer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ToyWidget *ToyPedalGrid::CreateWidget()
 {
   ToyPedalWidget *w = new ToyPedalWidget(this);
@@ -510,15 +514,16 @@ ToyWidget *ToyPedalGrid::CreateWidget()
 
 void ToyPedalGrid::StartTimer()
 {
-  m_ElapsedTimer.Start();
-  m_Timer->start(Toy::GetPedalRefreshRateMS());
+  QString name;
+  Toy::GetName(m_Type, name);
+  FS.Subscribe(*this, name, Toy::GetPedalRefreshRateMS(), /*active*/ true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToyPedalGrid::StopTimer()
 {
-  m_Timer->stop();
+  FS.Unsubscribe(*this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -555,30 +560,25 @@ void ToyPedalGrid::onTick(ToyPedalWidget *pedal, float value)
 {
   if (m_pClient && pedal && !pedal->GetPath().isEmpty())
   {
-    QString path(pedal->GetPath());
-    bool local = Utils::MakeLocalOSCPath(false, path);
+    size_t floatCount = 0;
 
-    OSCPacketWriter packetWriter(path.toUtf8().constData());
-    if (!pedal->GetMin().isEmpty() || !pedal->GetMax().isEmpty())
+    const ToyWidget::sValue &minValue = pedal->GetMinValue();
+    const ToyWidget::sValue &maxValue = pedal->GetMaxValue();
+    if (!minValue.isEmpty || !maxValue.isEmpty)
     {
-      float minValue = pedal->GetMin().toFloat();
-      float maxValue = pedal->GetMax().toFloat();
-      value = (minValue + (maxValue - minValue) * value);
-      packetWriter.AddFloat32(value);
+      value = (minValue.value + (maxValue.value - minValue.value) * value);
+      floatCount = 1;
     }
 
-    size_t size;
-    char *packet = packetWriter.Create(size);
-    if (packet)
-      m_pClient->ToyClient_Send(local, packet, size);
+    const OSCPacketTemplate &packetTemplate = pedal->GetPathTemplate(floatCount);
+    m_pClient->ToyClient_Send(packetTemplate, &value, floatCount);
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToyPedalGrid::onTimeout()
+void ToyPedalGrid::FrameSchedulerClient_Tick(unsigned int ms)
 {
-  unsigned int ms = m_ElapsedTimer.Restart();
   for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
     static_cast<ToyPedalWidget *>(*i)->Update(ms);
 }
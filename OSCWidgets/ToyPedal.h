@@ -130,12 +130,13 @@ private slots:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class ToyPedalGrid : public ToyGrid
+class ToyPedalGrid : public ToyGrid, private FrameScheduler::FrameSchedulerClient
 {
   Q_OBJECT
 
 public:
   ToyPedalGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags);
+  virtual ~ToyPedalGrid();
 
   virtual void GetDefaultGridSize(QSize &gridSize) const { gridSize = QSize(5, 1); }
   virtual void StartTimer();
@@ -143,16 +144,14 @@ public:
 
 private slots:
   void onTick(ToyPedalWidget *, float value);
-  void onTimeout();
   void onPressPressed();
   void onPressReleased();
 
 protected:
-  QTimer *m_Timer;
-  EosTimer m_ElapsedTimer;
   FadeButton *m_Press;
 
   virtual ToyWidget *CreateWidget();
+  virtual void FrameSchedulerClient_Tick(unsigned int ms);
   virtual void UpdateLayout();
   virtual void AutoSize(const QSize &widgetSize);
 };
@@ -31,16 +31,37 @@ FadeSine::FadeSine(QWidget *parent)
   , m_Pos(0)
   , m_BPM(60.0f)
   , m_Paused(true)
+  , m_Clocked(false)
+  , m_Waveform(Wavetable::WAVEFORM_SINE)
+  , m_PhaseOffset(0)
+  , m_Duty(0.5f)
 {
   connect(this, SIGNAL(clicked(bool)), this, SLOT(onClicked(bool)));
-  UpdateSpeed();
+
+  m_GeneratorId = GEN.Add(GeneratorThread::GENERATOR_SINE, Toy::GetSineRefreshRateMS());
+  GEN.SetBPM(m_GeneratorId, m_BPM);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FadeSine::~FadeSine()
+{
+  GEN.Remove(m_GeneratorId);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void FadeSine::ReCenter()
 {
-  m_Pos = 0;
+  SetPos(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FadeSine::SetPos(float pos)
+{
+  m_Pos = pos;
+  GEN.SetPos(m_GeneratorId, m_Pos);
   update();
 }
 
@@ -100,7 +121,7 @@ void FadeSine::SetBPM(float bpm)
   if (m_BPM != bpm)
   {
     m_BPM = bpm;
-    UpdateSpeed();
+    GEN.SetBPM(m_GeneratorId, m_BPM);
   }
 }
 
@@ -111,33 +132,60 @@ void FadeSine::SetPaused(bool b)
   if (m_Paused != b)
   {
     m_Paused = b;
+    GEN.SetPaused(m_GeneratorId, m_Paused);
     update();
+    emit pausedChanged();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeSine::UpdateSpeed()
+void FadeSine::SetClock(const QString &clock)
 {
-  float beatsPerMillisecond = (m_BPM / 60000);
-  m_Speed = (beatsPerMillisecond * M_PI);
+  m_Clocked = !clock.isEmpty();
+  GEN.SetClock(m_GeneratorId, clock);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void FadeSine::Update(unsigned int ms)
+void FadeSine::SetWaveform(Wavetable::EnumWaveform waveform, float phaseOffset, float duty)
 {
-  if (!m_Paused && ms != 0)
+  if (m_Waveform != waveform || m_PhaseOffset != phaseOffset || m_Duty != duty)
   {
-    m_Pos = fmod(m_Pos + ms * m_Speed, static_cast<float>(TWO_PI));
-    float percent = (sinf(m_Pos) + 1) * 0.5f;
-    emit tick(percent);
+    m_Waveform = waveform;
+    m_PhaseOffset = phaseOffset;
+    m_Duty = duty;
+    GEN.SetWaveform(m_GeneratorId, m_Waveform, m_PhaseOffset, m_Duty);
     update();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void FadeSine::Update(unsigned int /*ms*/)
+{
+  // the generator thread owns the phase, just follow it for drawing
+  GeneratorThread::sState state;
+  if ((!m_Paused || m_Clocked) && GEN.GetState(m_GeneratorId, state))
+  {
+    // a clocked widget can also be started or stopped by its group
+    if (m_Paused != state.paused)
+    {
+      m_Paused = state.paused;
+      update();
+      emit pausedChanged();
+    }
+
+    if (m_Pos != state.pos)
+    {
+      m_Pos = state.pos;
+      update();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void FadeSine::resizeEvent(QResizeEvent *event)
 {
   FadeButton::resizeEvent(event);
@@ -162,7 +210,7 @@ void FadeSine::paintEvent(QPaintEvent * /*event*/)
   const QPixmap &pixmap = m_Images[m_ImageIndex].pixmap;
   if (!pixmap.isNull())
   {
-    painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, r, pixmap);
   }
 
   painter.setClipping(false);
@@ -190,7 +238,7 @@ void FadeSine::paintEvent(QPaintEvent * /*event*/)
   {
     float percent = (1.0f - i * toPercent);
     float t = (TWO_PI * percent);
-    float y = ((sinf(m_Pos + t) + 1.0f) * 0.5f);
+    float y = Wavetable::Lookup(m_Waveform, (m_Pos + t) / TWO_PI + m_PhaseOffset, m_Duty);
     m_Points[i].setX(sineX + percent * sineWidth);
     m_Points[i].setY(sineY + sineHeight * (1.0f - y));
   }
@@ -258,12 +306,14 @@ void FadeSine::onClicked(bool /*checked*/)
 ToySineWidget::ToySineWidget(QWidget *parent)
   : ToyWidget(parent)
 {
-  m_HelpText = tr("Min=Peak\nMax=Valley\n\nOSC Trigger:\nNo Arguments = Play\nArgument(0) = Pause\nArgument(1) = Play");
+  m_HelpText = tr("Min=Peak\nMax=Valley\nWave=LFO Shape\nPhase=Offset in Degrees\nDuty=Pulse Width in Percent\n\nOSC Trigger:\nNo Arguments = Play\nArgument(0) = Pause\nArgument(1) = Play");
 
   m_Widget = new FadeSine(this);
-  connect(m_Widget, SIGNAL(tick(float)), this, SLOT(onTick(float)));
+  connect(m_Widget, SIGNAL(pausedChanged()), this, SIGNAL(runningChanged()));
+
+  ToyWidget::SetBPM(QString::number(static_cast<FadeSine *>(m_Widget)->GetBPM()));
 
-  m_BPM = QString::number(static_cast<FadeSine *>(m_Widget)->GetBPM());
+  UpdateGeneratorOutput();
 
   QPalette pal(m_Widget->palette());
   m_Color = pal.color(QPalette::Button);
@@ -308,15 +358,108 @@ void ToySineWidget::SetTextColor(const QColor &textColor)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToySineWidget::SetPath(const QString &path)
+{
+  ToyWidget::SetPath(path);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::SetMin(const QString &n)
+{
+  ToyWidget::SetMin(n);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::SetMax(const QString &n)
+{
+  ToyWidget::SetMax(n);
+  UpdateGeneratorOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::UpdateGeneratorOutput()
+{
+  GeneratorThread::sOutput output;
+
+  if (!m_Path.isEmpty())
+  {
+    output.enabled = true;
+    output.min = 0;
+    output.max = 1.0f;
+
+    if (!m_MinValue.isEmpty || !m_MaxValue.isEmpty)
+    {
+      output.min = m_MinValue.value;
+      output.max = m_MaxValue.value;
+      output.floatCount = 1;
+    }
+
+    output.packetTemplate = GetPathTemplate(output.floatCount);
+    output.local = output.packetTemplate.GetLocal();
+  }
+
+  GEN.SetOutput(static_cast<FadeSine *>(m_Widget)->GetGeneratorId(), output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToySineWidget::SetBPM(const QString &bpm)
 {
   ToyWidget::SetBPM(bpm);
-  float n = m_BPM.toFloat();
+  float n = m_BPMValue.value;
   static_cast<FadeSine *>(m_Widget)->SetBPM(qBound(0.0f, n, 300.0f));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToySineWidget::SetClock(const QString &clock)
+{
+  ToyWidget::SetClock(clock);
+  static_cast<FadeSine *>(m_Widget)->SetClock(m_Clock);
+  emit runningChanged();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::SetWaveform(const QString &waveform)
+{
+  ToyWidget::SetWaveform(waveform);
+  UpdateWaveform();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::SetPhase(const QString &phase)
+{
+  ToyWidget::SetPhase(phase);
+  UpdateWaveform();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::SetDuty(const QString &duty)
+{
+  ToyWidget::SetDuty(duty);
+  UpdateWaveform();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineWidget::UpdateWaveform()
+{
+  // phase in degrees, duty in percent
+  float phaseOffset = (m_PhaseValue.value / 360.0f);
+  float duty = (m_DutyValue.isEmpty ? 0.5f : qBound(0.01f, m_DutyValue.value * 0.01f, 0.99f));
+  static_cast<FadeSine *>(m_Widget)->SetWaveform(Wavetable::GetWaveformForName(m_Waveform), phaseOffset, duty);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToySineWidget::SetLabel(const QString &label)
 {
   static_cast<FadeSine *>(m_Widget)->SetLabel(label);
@@ -360,19 +503,9 @@ void ToySineWidget::Update(unsigned int ms)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToySineWidget::onTick(float value)
-{
-  emit tick(this, value);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
 ToySineGrid::ToySineGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags)
   : ToyGrid(TOY_SINE_GRID, pClient, parent, flags)
 {
-  m_Timer = new QTimer(this);
-  connect(m_Timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
-
   m_Play = new FadeButton(this);
   m_Play->setText(tr("Play All"));
   m_Play->resize(m_Play->sizeHint());
@@ -395,26 +528,72 @@ ToySineGrid::ToySineGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags
 
 ////////////////////////////////////////////////////////////////////////////////
 
+ToySineGrid::~ToySineGrid()
+{
+  StopTimer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ToyWidget *ToySineGrid::CreateWidget()
 {
-  ToySineWidget *w = new ToySineWidget(this);
-  connect(w, SIGNAL(tick(ToySineWidget *, float)), this, SLOT(onTick(ToySineWidget *, float)));
-  return w;
+  return (new ToySineWidget(this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToySineGrid::StartTimer()
 {
-  m_ElapsedTimer.Start();
-  m_Timer->start(Toy::GetSineRefreshRateMS());
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    GEN.SetInterval(static_cast<ToySineWidget *>(*i)->GetSine().GetGeneratorId(), Toy::GetSineRefreshRateMS());
+
+  QString name;
+  Toy::GetName(m_Type, name);
+  FS.Subscribe(*this, name, Toy::GetVisualIntervalMS(*this, Toy::GetSineVisualRateMS()), /*active*/ false);
+  UpdateVisuals();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineGrid::UpdateVisuals()
+{
+  unsigned int intervalMS = GetVisualsIntervalMS(Toy::GetSineVisualRateMS());
+  if (intervalMS != 0)
+    FS.SetInterval(*this, intervalMS);
+  FS.SetActive(*this, intervalMS != 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void ToySineGrid::StopTimer()
 {
-  m_Timer->stop();
+  FS.Unsubscribe(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineGrid::SetGridSize(const QSize &gridSize)
+{
+  ToyGrid::SetGridSize(gridSize);
+  UpdateVisuals();
+  UpdateLookahead();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineGrid::SetLookahead(const QString &lookahead)
+{
+  ToyGrid::SetLookahead(lookahead);
+  UpdateLookahead();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToySineGrid::UpdateLookahead()
+{
+  unsigned int lookaheadMS = static_cast<unsigned int>(qBound(0, m_Lookahead.toInt(), 1000));
+  for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    GEN.SetLookahead(static_cast<ToySineWidget *>(*i)->GetSine().GetGeneratorId(), lookaheadMS);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -500,35 +679,8 @@ void ToySineGrid::AutoSize(const QSize &widgetSize)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ToySineGrid::onTick(ToySineWidget *sine, float value)
-{
-  if (m_pClient && sine && !sine->GetPath().isEmpty())
-  {
-    QString path(sine->GetPath());
-    bool local = Utils::MakeLocalOSCPath(false, path);
-
-    OSCPacketWriter packetWriter(path.toUtf8().constData());
-
-    if (!sine->GetMin().isEmpty() || !sine->GetMax().isEmpty())
-    {
-      float minValue = sine->GetMin().toFloat();
-      float maxValue = sine->GetMax().toFloat();
-      value = (minValue + (maxValue - minValue) * value);
-      packetWriter.AddFloat32(value);
-    }
-
-    size_t size;
-    char *packet = packetWriter.Create(size);
-    if (packet)
-      m_pClient->ToyClient_Send(local, packet, size);
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void ToySineGrid::onTimeout()
+void ToySineGrid::FrameSchedulerClient_Tick(unsigned int ms)
 {
-  unsigned int ms = m_ElapsedTimer.Restart();
   for (WIDGET_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
     static_cast<ToySineWidget *>(*i)->Update(ms);
 }
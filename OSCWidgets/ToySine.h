@@ -26,6 +26,10 @@
 #include "ToyButton.h"
 #endif
 
+#ifndef GENERATOR_THREAD_H
+#include "GeneratorThread.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class FadeSine : public FadeButton
@@ -34,14 +38,12 @@ class FadeSine : public FadeButton
 
 public:
   FadeSine(QWidget *parent);
+  virtual ~FadeSine();
 
+  virtual GeneratorThread::ID GetGeneratorId() const { return m_GeneratorId; }
   virtual void ReCenter();
   virtual float GetPos() const { return m_Pos; }
-  virtual void SetPos(float pos)
-  {
-    m_Pos = pos;
-    update();
-  }
+  virtual void SetPos(float pos);
   virtual void SetText(const QString &text);
   virtual void SetLabel(const QString &label);
   virtual void Update(unsigned int ms);
@@ -49,9 +51,11 @@ public:
   virtual void SetBPM(float bpm);
   virtual bool GetPaused() const { return m_Paused; }
   virtual void SetPaused(bool b);
+  virtual void SetClock(const QString &clock);
+  virtual void SetWaveform(Wavetable::EnumWaveform waveform, float phaseOffset, float duty);
 
 signals:
-  void tick(float value);
+  void pausedChanged();
 
 private slots:
   void onClicked(bool checked);
@@ -64,13 +68,16 @@ protected:
 
   int m_TextMargin;
   int m_LabelMargin;
+  GeneratorThread::ID m_GeneratorId;
   float m_Pos;
-  float m_Speed;
   float m_BPM;
   bool m_Paused;
+  bool m_Clocked;
+  Wavetable::EnumWaveform m_Waveform;
+  float m_PhaseOffset;
+  float m_Duty;
   QPointF m_Points[NUM_POINTS];
 
-  virtual void UpdateSpeed();
   virtual void AutoSizeFont();
   virtual void UpdateMargins();
   virtual void resizeEvent(QResizeEvent *event);
@@ -90,53 +97,64 @@ public:
   virtual void SetImagePath(const QString &imagePath);
   virtual void SetColor(const QColor &color);
   virtual void SetTextColor(const QColor &textColor);
+  virtual void SetPath(const QString &path);
+  virtual void SetMin(const QString &n);
+  virtual void SetMax(const QString &n);
   virtual bool HasTriggerPath() const { return true; }
   virtual void SetBPM(const QString &bpm);
   virtual bool HasBPM() const { return true; }
+  virtual void SetClock(const QString &clock);
+  virtual bool HasClock() const { return true; }
+  virtual bool IsRunning() const { return !static_cast<const FadeSine *>(m_Widget)->GetPaused(); }
+  virtual void SetWaveform(const QString &waveform);
+  virtual void SetPhase(const QString &phase);
+  virtual void SetDuty(const QString &duty);
+  virtual bool HasWaveform() const { return true; }
   virtual void SetLabel(const QString &label);
   virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
   virtual void Update(unsigned int ms);
   virtual FadeSine &GetSine() { return *static_cast<FadeSine *>(m_Widget); }
 
-signals:
-  void tick(ToySineWidget *, float value);
-
-private slots:
-  void onTick(float value);
+protected:
+  virtual void UpdateGeneratorOutput();
+  virtual void UpdateWaveform();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class ToySineGrid : public ToyGrid
+class ToySineGrid : public ToyGrid, private FrameScheduler::FrameSchedulerClient
 {
   Q_OBJECT
 
 public:
   ToySineGrid(Client *pClient, QWidget *parent, Qt::WindowFlags flags);
+  virtual ~ToySineGrid();
 
   virtual void StartTimer();
   virtual void StopTimer();
+  virtual void SetGridSize(const QSize &gridSize);
+  virtual void SetLookahead(const QString &lookahead);
+  virtual bool HasLookahead() const { return true; }
 
 private slots:
-  void onTick(ToySineWidget *, float value);
-  void onTimeout();
   void onPlayClicked(bool checked);
   void onPauseClicked(bool checked);
   void onReCenterClicked(bool checked);
   void onFanClicked(bool checked);
 
 protected:
-  QTimer *m_Timer;
-  EosTimer m_ElapsedTimer;
   FadeButton *m_Play;
   FadeButton *m_Pause;
   FadeButton *m_ReCenter;
   FadeButton *m_Fan;
 
   virtual ToyWidget *CreateWidget();
+  virtual void FrameSchedulerClient_Tick(unsigned int ms);
+  virtual void UpdateVisuals();
   virtual QSize GetDefaultWidgetSize() const { return QSize(180, 120); }
   virtual void UpdateLayout();
   virtual void AutoSize(const QSize &widgetSize);
+  virtual void UpdateLookahead();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -239,7 +239,7 @@ void FadeSlider::paintEvent(QPaintEvent * /*event*/)
   const QPixmap &pixmap = m_Images[m_ImageIndex].pixmap;
   if (!pixmap.isNull())
   {
-    painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, r, pixmap);
   }
 
   painter.setClipping(false);
@@ -405,8 +405,8 @@ void ToySliderWidget::Recv(const QString &path, const OSCArgument *args, size_t
       if (!args[0].GetFloat(value))
         value = 0;
 
-      float minValue = m_Min.toFloat();
-      float maxValue = m_Max.toFloat();
+      float minValue = m_MinValue.value;
+      float maxValue = m_MaxValue.value;
       float range = (maxValue - minValue);
       value = ((range == 0) ? 0 : (value - minValue) / range);
       if (value < 0)
@@ -459,23 +459,19 @@ void ToySliderGrid::onPercentChanged(ToySliderWidget *slider)
 {
   if (m_pClient && slider && !slider->GetPath().isEmpty())
   {
-    QString path(slider->GetPath());
-    bool local = Utils::MakeLocalOSCPath(false, path);
+    float value = 0;
+    size_t floatCount = 0;
 
-    OSCPacketWriter packetWriter(path.toUtf8().constData());
-
-    if (!slider->GetMin().isEmpty() || !slider->GetMax().isEmpty())
+    const ToyWidget::sValue &minValue = slider->GetMinValue();
+    const ToyWidget::sValue &maxValue = slider->GetMaxValue();
+    if (!minValue.isEmpty || !maxValue.isEmpty)
     {
-      float minValue = slider->GetMin().toFloat();
-      float maxValue = slider->GetMax().toFloat();
-      float value = (minValue + (maxValue - minValue) * slider->GetPercent());
-      packetWriter.AddFloat32(value);
+      value = (minValue.value + (maxValue.value - minValue.value) * slider->GetPercent());
+      floatCount = 1;
     }
 
-    size_t size;
-    char *packet = packetWriter.Create(size);
-    if (packet)
-      m_pClient->ToyClient_Send(local, packet, size);
+    const OSCPacketTemplate &packetTemplate = slider->GetPathTemplate(floatCount);
+    m_pClient->ToyClient_Send(packetTemplate, &value, floatCount);
   }
 }
 
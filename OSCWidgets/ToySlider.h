@@ -91,6 +91,7 @@ public:
   virtual void SetColor(const QColor &color);
   virtual void SetTextColor(const QColor &textColor);
   virtual bool HasFeedbackPath() const { return true; }
+  virtual bool CanCoalesceFeedback() const { return true; }
   virtual bool HasTriggerPath() const { return true; }
   virtual void SetLabel(const QString &label);
   virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
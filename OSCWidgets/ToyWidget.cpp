@@ -20,8 +20,10 @@
 
 #include "ToyWidget.h"
 #include "EditPanel.h"
+#include "FadeButton.h"
 #include "Toy.h"
 #include "Utils.h"
+#include "OSCParser.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -30,6 +32,12 @@ ToyWidget::ToyWidget(QWidget *parent)
   , m_Widget(0)
   , m_Mode(MODE_DEFAULT)
   , m_Visible(true)
+  , m_PaintedByGrid(false)
+  , m_PathId(OSCAddressTable::INVALID_ID)
+  , m_Path2Id(OSCAddressTable::INVALID_ID)
+  , m_LabelPathId(OSCAddressTable::INVALID_ID)
+  , m_FeedbackPathId(OSCAddressTable::INVALID_ID)
+  , m_TriggerPathId(OSCAddressTable::INVALID_ID)
   , m_Min("0")
   , m_Max("1")
   , m_Min2("0")
@@ -38,6 +46,22 @@ ToyWidget::ToyWidget(QWidget *parent)
   m_EditButton = new EditButton(this);
   m_EditButton->hide();
   connect(m_EditButton, SIGNAL(clicked(bool)), this, SLOT(onEditButtonClicked(bool)));
+
+  ParseValue(m_Min, m_MinValue);
+  ParseValue(m_Max, m_MaxValue);
+  ParseValue(m_Min2, m_Min2Value);
+  ParseValue(m_Max2, m_Max2Value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ToyWidget::~ToyWidget()
+{
+  OAT.Release(m_PathId);
+  OAT.Release(m_Path2Id);
+  OAT.Release(m_LabelPathId);
+  OAT.Release(m_FeedbackPathId);
+  OAT.Release(m_TriggerPathId);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,7 +107,56 @@ void ToyWidget::SetVisible(bool b)
 
 void ToyWidget::UpdateVisible()
 {
-  setVisible(m_Visible || m_Mode == MODE_EDIT);
+  if (m_PaintedByGrid)
+  {
+    // drawn by the grid, except while selected for editing
+    setVisible(m_Mode == MODE_EDIT && GetSelected());
+    UpdateCell();
+  }
+  else
+    setVisible(m_Visible || m_Mode == MODE_EDIT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetPaintedByGrid(bool b)
+{
+  if (m_PaintedByGrid != b)
+  {
+    m_PaintedByGrid = b;
+    UpdateVisible();
+    UpdatePaintedByGrid();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetLiveResize(bool b)
+{
+  FadeButton *button = qobject_cast<FadeButton *>(m_Widget);
+  if (button)
+    button->SetLiveResize(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::GetCell(sCell &cell) const
+{
+  cell.visible = m_Visible;
+  cell.down = false;
+  cell.text = m_Text;
+  cell.label.clear();
+  cell.imagePath = m_ImagePath;
+  cell.color = m_Color;
+  cell.textColor = m_TextColor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::UpdateCell()
+{
+  if (m_PaintedByGrid)
+    emit cellChanged(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,7 +165,10 @@ void ToyWidget::SetLabelPath(const QString &labelPath)
 {
   if (m_LabelPath != labelPath)
   {
-    m_LabelPath = labelPath;
+    OSCAddressTable::ID id = OAT.Intern(labelPath);
+    OAT.Release(m_LabelPathId);
+    m_LabelPathId = id;
+    m_LabelPath = OAT.Get(m_LabelPathId).path;
     UpdateToolTip();
   }
 }
@@ -103,7 +179,10 @@ void ToyWidget::SetFeedbackPath(const QString &feedbackPath)
 {
   if (m_FeedbackPath != feedbackPath)
   {
-    m_FeedbackPath = feedbackPath;
+    OSCAddressTable::ID id = OAT.Intern(feedbackPath);
+    OAT.Release(m_FeedbackPathId);
+    m_FeedbackPathId = id;
+    m_FeedbackPath = OAT.Get(m_FeedbackPathId).path;
     UpdateToolTip();
   }
 }
@@ -114,7 +193,10 @@ void ToyWidget::SetTriggerPath(const QString &triggerPath)
 {
   if (m_TriggerPath != triggerPath)
   {
-    m_TriggerPath = triggerPath;
+    OSCAddressTable::ID id = OAT.Intern(triggerPath);
+    OAT.Release(m_TriggerPathId);
+    m_TriggerPathId = id;
+    m_TriggerPath = OAT.Get(m_TriggerPathId).path;
     UpdateToolTip();
   }
 }
@@ -125,7 +207,11 @@ void ToyWidget::SetPath(const QString &path)
 {
   if (m_Path != path)
   {
-    m_Path = path;
+    OSCAddressTable::ID id = OAT.Intern(path);
+    OAT.Release(m_PathId);
+    m_PathId = id;
+    m_Path = OAT.Get(m_PathId).path;
+    m_PathTemplate.Clear();
     UpdateToolTip();
   }
 }
@@ -136,13 +222,111 @@ void ToyWidget::SetPath2(const QString &path)
 {
   if (m_Path2 != path)
   {
-    m_Path2 = path;
+    OSCAddressTable::ID id = OAT.Intern(path);
+    OAT.Release(m_Path2Id);
+    m_Path2Id = id;
+    m_Path2 = OAT.Get(m_Path2Id).path;
+    m_Path2Template.Clear();
     UpdateToolTip();
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+const OSCPacketTemplate &ToyWidget::GetPathTemplate(size_t floatCount)
+{
+  if (m_PathTemplate.IsEmpty() || m_PathTemplate.GetFloatCount() != floatCount)
+    m_PathTemplate.Build(m_PathId, floatCount);
+
+  return m_PathTemplate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const OSCPacketTemplate &ToyWidget::GetPath2Template(size_t floatCount)
+{
+  if (m_Path2Template.IsEmpty() || m_Path2Template.GetFloatCount() != floatCount)
+    m_Path2Template.Build(m_Path2Id, floatCount);
+
+  return m_Path2Template;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetMin(const QString &n)
+{
+  m_Min = n;
+  ParseValue(m_Min, m_MinValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetMax(const QString &n)
+{
+  m_Max = n;
+  ParseValue(m_Max, m_MaxValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetMin2(const QString &n)
+{
+  m_Min2 = n;
+  ParseValue(m_Min2, m_Min2Value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetMax2(const QString &n)
+{
+  m_Max2 = n;
+  ParseValue(m_Max2, m_Max2Value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetBPM(const QString &bpm)
+{
+  m_BPM = bpm;
+  ParseValue(m_BPM, m_BPMValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetPhase(const QString &phase)
+{
+  m_Phase = phase;
+  ParseValue(m_Phase, m_PhaseValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::SetDuty(const QString &duty)
+{
+  m_Duty = duty;
+  ParseValue(m_Duty, m_DutyValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWidget::ParseValue(const QString &str, sValue &v)
+{
+  v.isEmpty = str.isEmpty();
+  if (v.isEmpty)
+  {
+    v.isFloat = false;
+    v.value = 0;
+  }
+  else
+  {
+    // matches previous per-message behavior: non-numeric strings evaluate to 0
+    v.isFloat = OSCArgument::IsFloatString(str.toUtf8().constData());
+    v.value = str.toFloat();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool ToyWidget::GetSelected() const
 {
   return m_EditButton->GetSelected();
@@ -153,6 +337,9 @@ bool ToyWidget::GetSelected() const
 void ToyWidget::SetSelected(bool selected)
 {
   m_EditButton->SetSelected(selected);
+
+  if (m_PaintedByGrid)
+    UpdateVisible();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -193,7 +380,10 @@ void ToyWidget::UpdateToolTip()
     tip.append(tr("OSC Trigger: %1").arg(m_TriggerPath));
   }
 
-  m_Widget->setToolTip(tip);
+  if (m_Widget)
+    m_Widget->setToolTip(tip);
+  else
+    setToolTip(tip);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,10 +399,35 @@ void ToyWidget::ClearLabel()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyWidget::AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const
+{
+  if (!m_ImagePath.isEmpty())
+    prefetch.paths.push_back(m_ImagePath);
+  if (HasImagePath2() && !m_ImagePath2.isEmpty())
+    prefetch.paths.push_back(m_ImagePath2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyWidget::Recv(const QString & /*path*/, const OSCArgument * /*args*/, size_t /*count*/) {}
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool ToyWidget::CanCoalesceRecv(OSCAddressTable::ID pathId) const
+{
+  // labels only reflect the latest value and triggers are actions; feedback is an action
+  // too (toggles, flashes, press/release) unless the widget type says it is plain state
+  if (pathId == OSCAddressTable::INVALID_ID || pathId == m_TriggerPathId)
+    return false;
+
+  if (pathId == m_FeedbackPathId)
+    return CanCoalesceFeedback();
+
+  return (pathId == m_LabelPathId);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool ToyWidget::Save(EosLog &log, const QString &path, QStringList &lines)
 {
   QString line;
@@ -241,6 +456,10 @@ bool ToyWidget::Save(EosLog &log, const QString &path, QStringList &lines)
   line.append(QString(", %1").arg(m_Min2));
   line.append(QString(", %1").arg(m_Max2));
   line.append(QString(", %1").arg(m_BPM));
+  line.append(QString(", %1").arg(Utils::QuotedString(m_Waveform)));
+  line.append(QString(", %1").arg(m_Phase));
+  line.append(QString(", %1").arg(m_Duty));
+  line.append(QString(", %1").arg(Utils::QuotedString(m_Clock)));
 
   lines << line;
   return true;
@@ -321,6 +540,21 @@ bool ToyWidget::Load(EosLog &log, const QString &path, QStringList &lines, int &
     if (HasBPM() && items.size() > 17)
       SetBPM(items[17]);
 
+    if (HasWaveform())
+    {
+      if (items.size() > 18)
+        SetWaveform(items[18]);
+
+      if (items.size() > 19)
+        SetPhase(items[19]);
+
+      if (items.size() > 20)
+        SetDuty(items[20]);
+    }
+
+    if (HasClock() && items.size() > 21)
+      SetClock(items[21]);
+
     return true;
   }
 
@@ -332,7 +566,8 @@ bool ToyWidget::Load(EosLog &log, const QString &path, QStringList &lines, int &
 void ToyWidget::resizeEvent(QResizeEvent *event)
 {
   QWidget::resizeEvent(event);
-  m_Widget->setGeometry(MARGIN, MARGIN, width() - MARGIN2, height() - MARGIN2);
+  if (m_Widget)
+    m_Widget->setGeometry(MARGIN, MARGIN, width() - MARGIN2, height() - MARGIN2);
   m_EditButton->setGeometry(0, 0, width(), height());
 }
 
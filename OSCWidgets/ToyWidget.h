@@ -26,6 +26,10 @@
 #include "QtInclude.h"
 #endif
 
+#ifndef UTILS_H
+#include "Utils.h"
+#endif
+
 class EditButton;
 class OSCArgument;
 class EosLog;
@@ -43,8 +47,39 @@ public:
     MODE_EDIT
   };
 
+  // pre-parsed form of a min/max/bpm string, so hot paths avoid QString conversions
+  struct sValue
+  {
+    sValue()
+      : isEmpty(true)
+      , isFloat(false)
+      , value(0)
+    {
+    }
+    bool isEmpty;
+    bool isFloat;
+    float value;
+  };
+
+  // everything a grid needs to draw this widget itself, when it has no child widget of its own
+  struct sCell
+  {
+    sCell()
+      : visible(true)
+      , down(false)
+    {
+    }
+    bool visible;
+    bool down;
+    QString text;
+    QString label;
+    QString imagePath;
+    QColor color;
+    QColor textColor;
+  };
+
   ToyWidget(QWidget *parent);
-  virtual ~ToyWidget() {}
+  virtual ~ToyWidget();
 
   virtual QWidget *GetWidget() { return m_Widget; }
   virtual EnumMode GetMode() const { return m_Mode; }
@@ -53,18 +88,31 @@ public:
   virtual void SetVisible(bool b);
   virtual bool HasVisible() const { return true; }
   virtual void UpdateVisible();
+  virtual bool GetPaintedByGrid() const { return m_PaintedByGrid; }
+  virtual void SetPaintedByGrid(bool b);
+  virtual void SetLiveResize(bool b);
+  virtual void GetCell(sCell &cell) const;
+  virtual void PressCell() {}
+  virtual void ReleaseCell() {}
   virtual const QString &GetPath() const { return m_Path; }
+  virtual OSCAddressTable::ID GetPathId() const { return m_PathId; }
   virtual void SetPath(const QString &path);
   virtual bool HasPath() const { return true; }
   virtual const QString &GetPath2() const { return m_Path2; }
+  virtual OSCAddressTable::ID GetPath2Id() const { return m_Path2Id; }
   virtual void SetPath2(const QString &path);
   virtual bool HasPath2() const { return false; }
+  virtual const OSCPacketTemplate &GetPathTemplate(size_t floatCount);
+  virtual const OSCPacketTemplate &GetPath2Template(size_t floatCount);
   virtual const QString &GetLabelPath() const { return m_LabelPath; }
+  virtual OSCAddressTable::ID GetLabelPathId() const { return m_LabelPathId; }
   virtual void SetLabelPath(const QString &labelPath);
   virtual const QString &GetFeedbackPath() const { return m_FeedbackPath; }
+  virtual OSCAddressTable::ID GetFeedbackPathId() const { return m_FeedbackPathId; }
   virtual void SetFeedbackPath(const QString &feedbackPath);
   virtual bool HasFeedbackPath() const { return false; }
   virtual const QString &GetTriggerPath() const { return m_TriggerPath; }
+  virtual OSCAddressTable::ID GetTriggerPathId() const { return m_TriggerPathId; }
   virtual void SetTriggerPath(const QString &triggerPath);
   virtual bool HasTriggerPath() const { return false; }
   virtual const QString &GetText() const { return m_Text; }
@@ -87,27 +135,53 @@ public:
   virtual bool GetSelected() const;
   virtual void SetSelected(bool selected);
   virtual const QString &GetMin() const { return m_Min; }
-  virtual void SetMin(const QString &n) { m_Min = n; }
+  virtual const sValue &GetMinValue() const { return m_MinValue; }
+  virtual void SetMin(const QString &n);
   virtual const QString &GetMax() const { return m_Max; }
-  virtual void SetMax(const QString &n) { m_Max = n; }
+  virtual const sValue &GetMaxValue() const { return m_MaxValue; }
+  virtual void SetMax(const QString &n);
   virtual bool HasMinMax() const { return true; }
   virtual const QString &GetMin2() const { return m_Min2; }
-  virtual void SetMin2(const QString &n) { m_Min2 = n; }
+  virtual const sValue &GetMin2Value() const { return m_Min2Value; }
+  virtual void SetMin2(const QString &n);
   virtual const QString &GetMax2() const { return m_Max2; }
-  virtual void SetMax2(const QString &n) { m_Max2 = n; }
+  virtual const sValue &GetMax2Value() const { return m_Max2Value; }
+  virtual void SetMax2(const QString &n);
   virtual bool HasMinMax2() const { return false; }
   virtual const QString &GetBPM() const { return m_BPM; }
-  virtual void SetBPM(const QString &bpm) { m_BPM = bpm; }
+  virtual const sValue &GetBPMValue() const { return m_BPMValue; }
+  virtual void SetBPM(const QString &bpm);
   virtual bool HasBPM() const { return false; }
+  virtual const QString &GetWaveform() const { return m_Waveform; }
+  virtual void SetWaveform(const QString &waveform) { m_Waveform = waveform; }
+  virtual const QString &GetPhase() const { return m_Phase; }
+  virtual const sValue &GetPhaseValue() const { return m_PhaseValue; }
+  virtual void SetPhase(const QString &phase);
+  virtual const QString &GetDuty() const { return m_Duty; }
+  virtual const sValue &GetDutyValue() const { return m_DutyValue; }
+  virtual void SetDuty(const QString &duty);
+  virtual bool HasWaveform() const { return false; }
+  virtual const QString &GetClock() const { return m_Clock; }
+  virtual void SetClock(const QString &clock) { m_Clock = clock; }
+  virtual bool HasClock() const { return false; }
+  virtual bool IsClocked() const { return (HasClock() && !m_Clock.isEmpty()); }
+  virtual bool IsRunning() const { return false; }
   virtual const QString &GetHelpText() const { return m_HelpText; }
   virtual void SetLabel(const QString &label);
   virtual void ClearLabel();
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const;
   virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
+  virtual bool CanCoalesceRecv(OSCAddressTable::ID pathId) const;
+  virtual bool CanCoalesceFeedback() const { return false; }
   virtual bool Save(EosLog &log, const QString &path, QStringList &lines);
   virtual bool Load(EosLog &log, const QString &path, QStringList &lines, int &index);
 
+  static void ParseValue(const QString &str, sValue &v);
+
 signals:
   void edit(ToyWidget *);
+  void runningChanged();
+  void cellChanged(ToyWidget *);
 
 private slots:
   void onEditButtonClicked(bool checked);
@@ -115,11 +189,19 @@ private slots:
 protected:
   EnumMode m_Mode;
   bool m_Visible;
+  bool m_PaintedByGrid;
   QString m_Path;
   QString m_Path2;
+  OSCPacketTemplate m_PathTemplate;
+  OSCPacketTemplate m_Path2Template;
   QString m_LabelPath;
   QString m_FeedbackPath;
   QString m_TriggerPath;
+  OSCAddressTable::ID m_PathId;
+  OSCAddressTable::ID m_Path2Id;
+  OSCAddressTable::ID m_LabelPathId;
+  OSCAddressTable::ID m_FeedbackPathId;
+  OSCAddressTable::ID m_TriggerPathId;
   QString m_Text;
   QString m_ImagePath;
   QString m_ImagePath2;
@@ -133,12 +215,25 @@ protected:
   QString m_Min2;
   QString m_Max2;
   QString m_BPM;
+  QString m_Waveform;
+  QString m_Phase;
+  QString m_Duty;
+  QString m_Clock;
+  sValue m_MinValue;
+  sValue m_MaxValue;
+  sValue m_Min2Value;
+  sValue m_Max2Value;
+  sValue m_BPMValue;
+  sValue m_PhaseValue;
+  sValue m_DutyValue;
   EditButton *m_EditButton;
   QString m_HelpText;
 
   virtual void resizeEvent(QResizeEvent *event);
   virtual void UpdateMode();
   virtual void UpdateToolTip();
+  virtual void UpdatePaintedByGrid() {}
+  virtual void UpdateCell();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
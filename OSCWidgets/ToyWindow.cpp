@@ -669,6 +669,14 @@ void ToyWindowTab::AddRecvWidgets(Toy::RECV_WIDGETS &recvWidgets) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyWindowTab::AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const
+{
+  for (FRAME_LIST::const_iterator i = m_Frames.begin(); i != m_Frames.end(); i++)
+    i->toy->AddImagePrefetch(prefetch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyWindowTab::ClearSelection()
 {
   for (FRAME_LIST::const_iterator i = m_Frames.begin(); i != m_Frames.end(); i++)
@@ -997,17 +1005,91 @@ void TabBar::paintEvent(QPaintEvent * /*event*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+ToyWindowTabProxy::ToyWindowTabProxy(ToyWindow *window, size_t tabIndex, QWidget *parent)
+  : ToyWidget(parent)
+  , m_Window(window)
+  , m_TabIndex(tabIndex)
+{
+  hide();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ToyWindowTabProxy::~ToyWindowTabProxy()
+{
+  ClearPaths();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindowTabProxy::ClearPaths()
+{
+  for (PATH_IDS::const_iterator i = m_RecvPathIds.begin(); i != m_RecvPathIds.end(); i++)
+    OAT.Release(*i);
+
+  m_RecvPathIds.clear();
+  m_ImagePaths.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindowTabProxy::AddRecvPath(const QString &path)
+{
+  // holds one reference per distinct path, like a widget would
+  OSCAddressTable::ID id = OAT.Intern(path);
+  if (id != OSCAddressTable::INVALID_ID && !m_RecvPathIds.insert(id).second)
+    OAT.Release(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindowTabProxy::AddImagePath(const QString &imagePath)
+{
+  if (!imagePath.isEmpty())
+    m_ImagePaths.push_back(imagePath);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindowTabProxy::AddRecvWidgets(Toy::RECV_WIDGETS &recvWidgets)
+{
+  for (PATH_IDS::const_iterator i = m_RecvPathIds.begin(); i != m_RecvPathIds.end(); i++)
+    recvWidgets.insert(Toy::RECV_WIDGETS_PAIR(*i, this));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindowTabProxy::AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const
+{
+  prefetch.paths.append(m_ImagePaths);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindowTabProxy::Recv(const QString &path, const OSCArgument *args, size_t count)
+{
+  m_Window->RecvPendingTab(m_TabIndex, path, args, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ToyWindow::ToyWindow(Client *pClient, QWidget *parent, Qt::WindowFlags flags)
   : ToyGrid(TOY_WINDOW, pClient, parent, flags)
   , m_TabIndex(0)
   , m_Color2(TEXT_COLOR)
   , m_TextColor(BG_COLOR)
+  , m_BuildingTab(false)
 {
   setAutoFillBackground(true);
 
   m_TabBar = new TabBar(this);
   UpdateTabs();
 
+  m_BuildTimer = new QTimer(this);
+  m_BuildTimer->setSingleShot(true);
+  m_BuildTimer->setInterval(BUILD_IDLE_MS);
+  connect(m_BuildTimer, SIGNAL(timeout()), this, SLOT(onBuildPendingTab()));
+
   connect(this, SIGNAL(layoutModeSelected()), this, SLOT(onLayoutModeSelected()));
 }
 
@@ -1102,6 +1184,8 @@ void ToyWindow::UpdateTabs()
       tabPal.setColor(QPalette::ButtonText, m_Color2);
     }
     tab.button->setPalette(tabPal);
+    if (selected && tab.pending)
+      BuildTab(i);
     tab.widget->setVisible(selected);
   }
 }
@@ -1257,6 +1341,22 @@ bool ToyWindow::Save(EosLog &log, const QString &path, QStringList &lines)
 
   for (TABS::const_iterator i = m_Tabs.begin(); i != m_Tabs.end(); i++)
   {
+    if (i->pending)
+    {
+      // never built, so write back what was read
+      lines << QString("%1, %2").arg(Utils::QuotedString(i->button->text())).arg(i->pendingFrames);
+
+      if (path == m_PendingPath)
+        lines << i->pendingLines;
+      else
+      {
+        QStringList pendingLines(i->pendingLines);
+        RebaseToyLines(log, m_PendingPath, path, pendingLines);
+        lines << pendingLines;
+      }
+      continue;
+    }
+
     const ToyWindowTab *tab = i->widget;
     const ToyWindowTab::FRAME_LIST &frames = tab->GetFrames();
 
@@ -1311,36 +1411,21 @@ bool ToyWindow::Load(EosLog &log, const QString &path, QStringList &lines, int &
       if (items.size() > 0)
         tab.button->setText(items[0]);
 
+      tab.pending = false;
+
       if (items.size() > 1)
       {
         int numFrames = items[1].toInt();
 
-        Toys::TOY_LIST addedToys;
-        addedToys.reserve(numFrames);
-
-        for (int frameIndex = 0; frameIndex < numFrames && index < lines.size(); frameIndex++)
-        {
-          Utils::GetItemsFromQuotedString(lines[index], items);
-
-          bool ok = false;
-          int n = items[0].toInt(&ok);
-          if (ok && n >= 0 && n < Toy::TOY_COUNT)
-          {
-            Toy *toy = AddToyToTab(tabIndex, static_cast<Toy::EnumToyType>(n), QSize(1, 1), QPoint(0, 0));
-            if (toy)
-            {
-              toy->Load(log, path, lines, index);
-              addedToys.push_back(toy);
-            }
-          }
-        }
-
-        // ensure proper z-ordering
-        for (Toys::TOY_LIST::const_iterator i = addedToys.begin(); i != addedToys.end(); i++)
-          (*i)->raise();
+        // only the tab on screen is built now, the rest wait for first show or idle time
+        if (tabIndex == m_TabIndex || numFrames <= 0)
+          LoadTab(log, path, lines, index, tabIndex, numFrames);
+        else
+          DeferTab(path, lines, index, tabIndex, numFrames);
       }
     }
 
+    m_PendingPath = path;
     m_Loading = false;
   }
 
@@ -1349,11 +1434,226 @@ bool ToyWindow::Load(EosLog &log, const QString &path, QStringList &lines, int &
 
   emit recvWidgetsChanged();
 
+  if (HasPendingTabs())
+    m_BuildTimer->start();
+
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ToyWindow::LoadTab(EosLog &log, const QString &path, QStringList &lines, int &index, size_t tabIndex, int numFrames)
+{
+  Toys::TOY_LIST addedToys;
+  addedToys.reserve(numFrames);
+
+  QStringList items;
+  for (int frameIndex = 0; frameIndex < numFrames && index < lines.size(); frameIndex++)
+  {
+    Utils::GetItemsFromQuotedString(lines[index], items);
+
+    bool ok = false;
+    int n = items[0].toInt(&ok);
+    if (ok && n >= 0 && n < Toy::TOY_COUNT)
+    {
+      Toy *toy = AddToyToTab(tabIndex, static_cast<Toy::EnumToyType>(n), QSize(1, 1), QPoint(0, 0));
+      if (toy)
+      {
+        toy->Load(log, path, lines, index);
+        addedToys.push_back(toy);
+      }
+    }
+  }
+
+  // ensure proper z-ordering
+  for (Toys::TOY_LIST::const_iterator i = addedToys.begin(); i != addedToys.end(); i++)
+    (*i)->raise();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindow::DeferTab(const QString &path, const QStringList &lines, int &index, size_t tabIndex, int numFrames)
+{
+  sTab &tab = m_Tabs[tabIndex];
+
+  if (tab.proxy)
+    tab.proxy->ClearPaths();
+  else
+    tab.proxy = new ToyWindowTabProxy(this, tabIndex, tab.widget);
+
+  int startIndex = index;
+
+  QStringList items;
+  for (int frameIndex = 0; frameIndex < numFrames && index < lines.size(); frameIndex++)
+  {
+    Utils::GetItemsFromQuotedString(lines[index++], items);
+
+    // step over the same lines the toy's own Load would read, keeping only what
+    // receiving and prefetching need
+    int numToyWidgets = GetToyWidgetCount(items);
+
+    if (items.size() > 10)
+    {
+      QString imagePath(items[10]);
+      Toy::ResourceRelativePathToAbsolute(0, path, imagePath);
+      tab.proxy->AddImagePath(imagePath);
+    }
+
+    for (int i = 0; i < numToyWidgets && index < lines.size(); i++)
+    {
+      Utils::GetItemsFromQuotedString(lines[index++], items);
+
+      // label, feedback and trigger paths
+      for (int j = 3; j <= 5 && j < items.size(); j++)
+        tab.proxy->AddRecvPath(items[j]);
+
+      for (int j = 7; j <= 8 && j < items.size(); j++)
+      {
+        QString imagePath(items[j]);
+        Toy::ResourceRelativePathToAbsolute(0, path, imagePath);
+        tab.proxy->AddImagePath(imagePath);
+      }
+    }
+  }
+
+  tab.pendingLines = lines.mid(startIndex, index - startIndex);
+  tab.pendingFrames = numFrames;
+  tab.pending = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindow::BuildTab(size_t tabIndex)
+{
+  if (tabIndex < m_Tabs.size() && m_Tabs[tabIndex].pending)
+  {
+    sTab &tab = m_Tabs[tabIndex];
+    tab.pending = false;
+
+    QStringList lines;
+    lines.swap(tab.pendingLines);
+
+    bool wasLoading = m_Loading;
+    m_Loading = m_BuildingTab = true;
+    int index = 0;
+    LoadTab(m_pClient->ToyClient_Log(), m_PendingPath, lines, index, tabIndex, tab.pendingFrames);
+    m_BuildingTab = false;
+    m_Loading = wasLoading;
+
+    // released only now the new widgets hold their own references, so no address is freed and
+    // re-interned under another id while a receive batch still holds the old ones
+    tab.proxy->ClearPaths();
+    tab.pendingFrames = 0;
+
+    UpdateLayout();
+
+    // this can run from inside a receive, so the table is rebuilt afterwards
+    QMetaObject::invokeMethod(this, "onRecvWidgetsChanged", Qt::QueuedConnection);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ToyWindow::HasPendingTabs() const
+{
+  for (TABS::const_iterator i = m_Tabs.begin(); i != m_Tabs.end(); i++)
+  {
+    if (i->pending)
+      return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindow::RecvPendingTab(size_t tabIndex, const QString &path, const OSCArgument *args, size_t count)
+{
+  if (tabIndex < m_Tabs.size())
+  {
+    // building interns and releases addresses, so path may point into the table
+    QString recvPath(path);
+
+    BuildTab(tabIndex);
+
+    RECV_WIDGETS recvWidgets;
+    m_Tabs[tabIndex].widget->AddRecvWidgets(recvWidgets);
+
+    for (RECV_WIDGETS_RANGE range = recvWidgets.equal_range(OAT.FindPath(recvPath)); range.first != range.second; range.first++)
+      range.first->second->Recv(recvPath, args, count);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int ToyWindow::GetToyWidgetCount(const QStringList &items)
+{
+  // ToyGrid::Load reads no more widget lines than its clamped grid holds
+  if (items.size() > 8)
+  {
+    int cols = items[7].toInt();
+    int rows = items[8].toInt();
+    int n = (cols * rows);
+    if (n > 0)
+      return qMin(n, qMax(cols, 1) * qMax(rows, 1));
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ToyWindow::RebaseResourcePath(EosLog &log, const QString &fromPath, const QString &toPath, QString &resourcePath)
+{
+  if (resourcePath.isEmpty())
+    return false;
+
+  QString rebased(resourcePath);
+  Toy::ResourceRelativePathToAbsolute(0, fromPath, rebased);
+  Toy::ResourceAbsolutePathToRelative(&log, toPath, rebased);
+  if (rebased == resourcePath)
+    return false;
+
+  resourcePath = rebased;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindow::RebaseToyLines(EosLog &log, const QString &fromPath, const QString &toPath, QStringList &lines)
+{
+  QStringList items;
+  int index = 0;
+  while (index < lines.size())
+  {
+    Utils::GetItemsFromQuotedString(lines[index], items);
+
+    int numToyWidgets = GetToyWidgetCount(items);
+
+    if (items.size() > 10 && RebaseResourcePath(log, fromPath, toPath, items[10]))
+      Utils::GetQuotedStringFromItems(items, lines[index]);
+
+    index++;
+
+    for (int i = 0; i < numToyWidgets && index < lines.size(); i++, index++)
+    {
+      Utils::GetItemsFromQuotedString(lines[index], items);
+
+      bool rebased = false;
+      for (int j = 7; j <= 8 && j < items.size(); j++)
+      {
+        if (RebaseResourcePath(log, fromPath, toPath, items[j]))
+          rebased = true;
+      }
+
+      if (rebased)
+        Utils::GetQuotedStringFromItems(items, lines[index]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ToyWindow::ClearLabels()
 {
   for (TABS::const_iterator i = m_Tabs.begin(); i != m_Tabs.end(); i++)
@@ -1365,7 +1665,25 @@ void ToyWindow::ClearLabels()
 void ToyWindow::AddRecvWidgets(RECV_WIDGETS &recvWidgets) const
 {
   for (TABS::const_iterator i = m_Tabs.begin(); i != m_Tabs.end(); i++)
-    i->widget->AddRecvWidgets(recvWidgets);
+  {
+    if (i->pending)
+      i->proxy->AddRecvWidgets(recvWidgets);
+    else
+      i->widget->AddRecvWidgets(recvWidgets);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindow::AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const
+{
+  for (TABS::const_iterator i = m_Tabs.begin(); i != m_Tabs.end(); i++)
+  {
+    if (i->pending)
+      i->proxy->AddImagePrefetch(prefetch);
+    else
+      i->widget->AddImagePrefetch(prefetch);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1558,7 +1876,27 @@ void ToyWindowTab::mouseReleaseEvent(QMouseEvent * /*event*/)
 
 void ToyWindow::onRecvWidgetsChanged()
 {
-  emit recvWidgetsChanged();
+  // a tab being built reports once it is done, not per toy
+  if (!m_BuildingTab)
+    emit recvWidgetsChanged();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ToyWindow::onBuildPendingTab()
+{
+  // one tab per idle tick keeps the event loop responsive
+  for (size_t i = 0; i < m_Tabs.size(); i++)
+  {
+    if (m_Tabs[i].pending)
+    {
+      BuildTab(i);
+      break;
+    }
+  }
+
+  if (HasPendingTabs())
+    m_BuildTimer->start();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@
 #include "ToyGrid.h"
 #endif
 
+#include <set>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,6 +133,7 @@ public:
   virtual const FRAME_LIST &GetFrames() const { return m_Frames; }
   virtual void ClearLabels();
   virtual void AddRecvWidgets(Toy::RECV_WIDGETS &recvWidgets) const;
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const;
   virtual void ClearSelection();
   virtual void SelectAll();
   virtual void SetToySelected(Toy *toy, bool b);
@@ -220,11 +222,44 @@ protected:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+class ToyWindow;
+
+// stands in for the contents of a tab that has not been built yet, listening on
+// every path its widgets would; the first message builds the tab and is passed on
+class ToyWindowTabProxy : public ToyWidget
+{
+public:
+  ToyWindowTabProxy(ToyWindow *window, size_t tabIndex, QWidget *parent);
+  virtual ~ToyWindowTabProxy();
+
+  virtual void ClearPaths();
+  virtual void AddRecvPath(const QString &path);
+  virtual void AddImagePath(const QString &imagePath);
+  virtual void AddRecvWidgets(Toy::RECV_WIDGETS &recvWidgets);
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const;
+  virtual void Recv(const QString &path, const OSCArgument *args, size_t count);
+
+protected:
+  typedef std::set<OSCAddressTable::ID> PATH_IDS;
+
+  ToyWindow *m_Window;
+  size_t m_TabIndex;
+  PATH_IDS m_RecvPathIds;
+  QStringList m_ImagePaths;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class ToyWindow : public ToyGrid
 {
   Q_OBJECT
 
 public:
+  enum EnumConstants
+  {
+    BUILD_IDLE_MS = 100
+  };
+
   ToyWindow(Client *pClient, QWidget *parent, Qt::WindowFlags flags);
 
   virtual void SetGridSize(const QSize &gridSize);
@@ -242,11 +277,14 @@ public:
   virtual bool Load(EosLog &log, const QString &path, QStringList &lines, int &index);
   virtual void ClearLabels();
   virtual void AddRecvWidgets(RECV_WIDGETS &recvWidgets) const;
+  virtual void AddImagePrefetch(PixmapCache::sPrefetch &prefetch) const;
+  virtual void RecvPendingTab(size_t tabIndex, const QString &path, const OSCArgument *args, size_t count);
 
   static int GetWidgetZOrder(QWidget &w);
 
 private slots:
   void onRecvWidgetsChanged();
+  void onBuildPendingTab();
   void onToyClosing(Toy *toy);
   void onToyChanged();
   void onToyToggledMainWindow();
@@ -260,10 +298,17 @@ protected:
     sTab()
       : button(0)
       , widget(0)
+      , proxy(0)
+      , pending(false)
+      , pendingFrames(0)
     {
     }
     TabButton *button;
     ToyWindowTab *widget;
+    ToyWindowTabProxy *proxy;
+    bool pending;
+    int pendingFrames;
+    QStringList pendingLines;
   };
 
   typedef std::vector<sTab> TABS;
@@ -276,11 +321,22 @@ protected:
   TabBar *m_TabBar;
   QColor m_Color2;
   QColor m_TextColor;
+  QString m_PendingPath;
+  QTimer *m_BuildTimer;
+  bool m_BuildingTab;
 
   virtual void UpdateMode();
   virtual void UpdateLayout();
   virtual void UpdateTabs();
   virtual Toy *AddToyToTab(size_t tabIndex, EnumToyType type, const QSize &gridSize, const QPoint &pos);
+  virtual void LoadTab(EosLog &log, const QString &path, QStringList &lines, int &index, size_t tabIndex, int numFrames);
+  virtual void DeferTab(const QString &path, const QStringList &lines, int &index, size_t tabIndex, int numFrames);
+  virtual void BuildTab(size_t tabIndex);
+  virtual bool HasPendingTabs() const;
+
+  static int GetToyWidgetCount(const QStringList &items);
+  static void RebaseToyLines(EosLog &log, const QString &fromPath, const QString &toPath, QStringList &lines);
+  static bool RebaseResourcePath(EosLog &log, const QString &fromPath, const QString &toPath, QString &resourcePath);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
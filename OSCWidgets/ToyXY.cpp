@@ -252,7 +252,7 @@ void FadeXY::paintEvent(QPaintEvent * /*event*/)
   const QPixmap &pixmap = m_Images[m_ImageIndex].pixmap;
   if (!pixmap.isNull())
   {
-    painter.drawPixmap(r.x() + qRound((r.width() - pixmap.width()) * 0.5), r.y() + qRound((r.height() - pixmap.height()) * 0.5), pixmap);
+    DrawCenteredPixmap(painter, r, pixmap);
   }
 
   painter.setClipping(false);
@@ -325,10 +325,10 @@ ToyXYWidget::ToyXYWidget(QWidget *parent)
 {
   m_HelpText = tr("OSC Output = X\nOSC Output 2 = Y\n\nLeave OSC Output 2 blank for single, combined (X,Y) output\n\nMin = Left\nMax = Right\n\nMin2 = Bottom\nMax2 = Top");
 
-  m_Min = "-1";
-  m_Max = "1";
-  m_Min2 = "-1";
-  m_Max2 = "1";
+  ToyWidget::SetMin("-1");
+  ToyWidget::SetMax("1");
+  ToyWidget::SetMin2("-1");
+  ToyWidget::SetMax2("1");
 
   m_Widget = new FadeXY(this);
   connect(m_Widget, SIGNAL(posChanged(const QPointF &)), this, SLOT(onPosChanged(const QPointF &)));
@@ -409,10 +409,10 @@ void ToyXYWidget::Recv(const QString &path, const OSCArgument *args, size_t coun
       if (count > 1 && args[1].GetFloat(value))
         pos.setY(value);
 
-      float minX = m_Min.toFloat();
-      float maxX = m_Max.toFloat();
-      float minY = m_Min2.toFloat();
-      float maxY = m_Max2.toFloat();
+      float minX = m_MinValue.value;
+      float maxX = m_MaxValue.value;
+      float minY = m_Min2Value.value;
+      float maxY = m_Max2Value.value;
       float rangeX = (maxX - minX);
       float rangeY = (maxY - minY);
       pos.setX(((rangeX == 0) ? 0 : (pos.x() - minX) / rangeX));
@@ -463,57 +463,27 @@ void ToyXYGrid::onPosChanged(ToyXYWidget *xy)
 {
   if (m_pClient && xy && !(xy->GetPath().isEmpty() && xy->GetPath2().isEmpty()))
   {
-    float minX = xy->GetMin().toFloat();
-    float maxX = xy->GetMax().toFloat();
-    float minY = xy->GetMin2().toFloat();
-    float maxY = xy->GetMax2().toFloat();
+    float minX = xy->GetMinValue().value;
+    float maxX = xy->GetMaxValue().value;
+    float minY = xy->GetMin2Value().value;
+    float maxY = xy->GetMax2Value().value;
     float x = (minX + (maxX - minX) * xy->GetPos().x());
     float y = (minY + (maxY - minY) * xy->GetPos().y());
 
-    QString path(xy->GetPath());
-    QString path2(xy->GetPath2());
-    if (path.isEmpty())
-    {
-      path = path2;
-      path2.clear();
-    }
-
-    if (path2.isEmpty())
+    if (xy->GetPath().isEmpty() || xy->GetPath2().isEmpty())
     {
       // combined packet
-      bool local = Utils::MakeLocalOSCPath(false, path);
-
-      OSCPacketWriter packetWriter(path.toUtf8().constData());
-      packetWriter.AddFloat32(x);
-      packetWriter.AddFloat32(y);
-
-      size_t size;
-      char *packet = packetWriter.Create(size);
-      if (packet)
-        m_pClient->ToyClient_Send(local, packet, size);
+      float values[2] = {x, y};
+      const OSCPacketTemplate &packetTemplate = (xy->GetPath().isEmpty() ? xy->GetPath2Template(2) : xy->GetPathTemplate(2));
+      m_pClient->ToyClient_Send(packetTemplate, values, 2);
     }
     else
     {
       // x
-      bool local = Utils::MakeLocalOSCPath(false, path);
-
-      OSCPacketWriter packetWriter(path.toUtf8().constData());
-      packetWriter.AddFloat32(x);
-
-      size_t size;
-      char *packet = packetWriter.Create(size);
-      if (packet)
-        m_pClient->ToyClient_Send(local, packet, size);
+      m_pClient->ToyClient_Send(xy->GetPathTemplate(1), &x, 1);
 
       // y
-      local = Utils::MakeLocalOSCPath(false, path2);
-
-      OSCPacketWriter packetWriter2(path2.toUtf8().constData());
-      packetWriter2.AddFloat32(y);
-
-      packet = packetWriter2.Create(size);
-      if (packet)
-        m_pClient->ToyClient_Send(local, packet, size);
+      m_pClient->ToyClient_Send(xy->GetPath2Template(1), &y, 1);
     }
   }
 }
@@ -92,6 +92,7 @@ public:
   virtual void SetTextColor(const QColor &textColor);
   virtual bool HasPath2() const { return true; }
   virtual bool HasFeedbackPath() const { return true; }
+  virtual bool CanCoalesceFeedback() const { return true; }
   virtual bool HasTriggerPath() const { return true; }
   virtual bool HasMinMax2() const { return true; }
   virtual void SetLabel(const QString &label);
@@ -22,12 +22,15 @@
 #include "Toys.h"
 
 #include "EosLog.h"
+#include "GeneratorThread.h"
 #include "OSCParser.h"
 #include "ToyWidget.h"
 #include "Utils.h"
 
 // TODO: restoring a maximized toy does not unmaximize to previous geometry
 
+#define CLOCK_PATH_PREFIX "/oscwidgets/clock/"
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Toys::Toys(Toy::Client *pClient, QWidget *pParent)
@@ -187,28 +190,80 @@ void Toys::ClearLabels()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool Toys::RecvClock(const char *data, size_t len)
+{
+  size_t pathLen = qstrnlen(data, static_cast<uint>(len));
+  if (!IsClockPath(data, pathLen))
+    return false;
+
+  size_t argCount = 0xffffffff;
+  OSCArgument *args = OSCArgument::GetArgs(const_cast<char *>(data), len, argCount);
+  RecvClock(data, pathLen, args, args ? argCount : 0);
+  if (args)
+    delete[] args;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Toys::RecvClock(const char *path, size_t pathLen, const OSCArgument *args, size_t argCount)
+{
+  // /oscwidgets/clock/<name>/bpm, tap, play or pause
+  if (!IsClockPath(path, pathLen))
+    return false;
+
+  const size_t prefixLen = (sizeof(CLOCK_PATH_PREFIX) - 1);
+  QString clockPath(QString::fromUtf8(path + prefixLen, static_cast<int>(pathLen - prefixLen)));
+  int index = clockPath.lastIndexOf(QLatin1Char('/'));
+  if (index <= 0)
+    return true;
+
+  QString name(clockPath.left(index));
+  QString cmd(clockPath.mid(index + 1));
+  if (cmd == QLatin1String("bpm"))
+  {
+    float bpm = 0;
+    if (args && argCount != 0 && args[0].GetFloat(bpm))
+      GEN.SetClockBPM(name, qBound(0.0, static_cast<double>(bpm), 600.0));
+  }
+  else if (cmd == QLatin1String("tap"))
+    GEN.TapClock(name);
+  else if (cmd == QLatin1String("play"))
+    GEN.SetClockPaused(name, false);
+  else if (cmd == QLatin1String("pause"))
+    GEN.SetClockPaused(name, true);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Toys::IsClockPath(const char *path, size_t pathLen)
+{
+  const size_t prefixLen = (sizeof(CLOCK_PATH_PREFIX) - 1);
+  return (path && pathLen > prefixLen && memcmp(path, CLOCK_PATH_PREFIX, prefixLen) == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Toys::Recv(char *data, size_t len)
 {
+  if (data && len != 0 && RecvClock(data, len))
+    return;
+
   if (data && len != 0 && (!m_RecvWidgets.empty() || !m_WildcardRecvWidgets.empty()))
   {
-    QString recvPath;
-
-    for (size_t i = 0; i < len; i++)
+    OSCAddressTable::ID recvPathId = GetRecvPathId(data, len);
+    if (recvPathId != OSCAddressTable::INVALID_ID)
     {
-      if (data[i] == 0)
-      {
-        if (i > 0)
-          recvPath = QString::fromUtf8(data);
-        break;
-      }
-    }
+      // a copy, since a widget's Recv can intern or release addresses
+      QString recvPath(OAT.Get(recvPathId).path);
 
-    if (!recvPath.isEmpty())
-    {
       size_t argCount = 0xffffffff;
       OSCArgument *args = OSCArgument::GetArgs(data, len, argCount);
 
-      for (Toy::RECV_WIDGETS_RANGE range = m_RecvWidgets.equal_range(recvPath); range.first != range.second; range.first++)
+      for (Toy::RECV_WIDGETS_RANGE range = m_RecvWidgets.equal_range(recvPathId); range.first != range.second; range.first++)
       {
         ToyWidget *w = range.first->second;
         w->Recv(recvPath, args, argCount);
@@ -263,6 +318,116 @@ void Toys::Recv(char *data, size_t len)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Toys::Recv(const PACKET_Q &packets)
+{
+  if (packets.empty())
+    return;
+
+  // group the batch by destination widget first, so label (and state-only feedback) messages
+  // superseded later in the same batch are never delivered; everything else is delivered in order
+  for (PACKET_Q::const_iterator i = packets.begin(); i != packets.end(); i++)
+  {
+    if (!i->data || i->size == 0 || RecvClock(i->data, i->size) || m_RecvWidgets.empty())
+      continue;
+
+    OSCAddressTable::ID recvPathId = GetRecvPathId(i->data, i->size);
+    if (recvPathId == OSCAddressTable::INVALID_ID)
+      continue;
+
+    Toy::RECV_WIDGETS_RANGE range = m_RecvWidgets.equal_range(recvPathId);
+    if (range.first == range.second)
+      continue;  // nothing bound, so skip argument parsing entirely
+
+    size_t argCount = 0xffffffff;
+    OSCArgument *args = OSCArgument::GetArgs(i->data, i->size, argCount);
+    if (args)
+      m_RecvArgs.push_back(args);
+
+    for (; range.first != range.second; range.first++)
+    {
+      sRecvItem item;
+      item.widget = range.first->second;
+      item.pathId = recvPathId;
+      item.args = args;
+      item.argCount = argCount;
+
+      if (item.widget->CanCoalesceRecv(recvPathId))
+      {
+        RECV_ITEM_KEY key(item.widget, recvPathId);
+        RECV_ITEM_INDICIES::iterator prev = m_RecvItemIndicies.find(key);
+        if (prev != m_RecvItemIndicies.end())
+        {
+          m_RecvItems[prev->second].widget = 0;
+          prev->second = m_RecvItems.size();
+        }
+        else
+          m_RecvItemIndicies.insert(std::make_pair(key, m_RecvItems.size()));
+      }
+
+      m_RecvItems.push_back(item);
+    }
+  }
+
+  // widgets only schedule update(), so each affected toy repaints once after the batch
+  for (RECV_ITEMS::const_iterator i = m_RecvItems.begin(); i != m_RecvItems.end(); i++)
+  {
+    if (i->widget)
+    {
+      QString recvPath(OAT.Get(i->pathId).path);
+      i->widget->Recv(recvPath, i->args, i->argCount);
+    }
+  }
+
+  for (RECV_ARGS::const_iterator i = m_RecvArgs.begin(); i != m_RecvArgs.end(); i++)
+    delete[] *i;
+
+  m_RecvItems.clear();
+  m_RecvItemIndicies.clear();
+  m_RecvArgs.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Toys::Recv(OSCLocalMessage &msg)
+{
+  // local messages arrive already typed, so there is no packet to parse
+  OSCArgument args[OSCLocalMessage::MAX_ARGS];
+  size_t argCount = msg.GetArgs(args, OSCLocalMessage::MAX_ARGS);
+
+  const QByteArray &address = msg.GetAddress();
+  if (RecvClock(address.constData(), static_cast<size_t>(address.size()), args, argCount) || m_RecvWidgets.empty())
+    return;
+
+  OSCAddressTable::ID recvPathId = OAT.Find(address.constData(), static_cast<size_t>(address.size()));
+  if (recvPathId == OSCAddressTable::INVALID_ID)
+    return;
+
+  // a copy, since a widget's Recv can intern or release addresses
+  QString recvPath(OAT.Get(recvPathId).path);
+
+  for (Toy::RECV_WIDGETS_RANGE range = m_RecvWidgets.equal_range(recvPathId); range.first != range.second; range.first++)
+  {
+    ToyWidget *w = range.first->second;
+    w->Recv(recvPath, (argCount != 0) ? args : 0, argCount);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCAddressTable::ID Toys::GetRecvPathId(const char *data, size_t len)
+{
+  // addresses that were never interned have no bound widgets
+  for (size_t i = 0; i < len; i++)
+  {
+    if (data[i] == 0)
+      return OAT.Find(data, i);
+  }
+
+  return OSCAddressTable::INVALID_ID;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Toys::BuildRecvWidgetsTable()
 {
   m_RecvWidgets.clear();
@@ -273,11 +438,11 @@ void Toys::BuildRecvWidgetsTable()
 
   for (Toy::RECV_WIDGETS::iterator i = m_RecvWidgets.begin(); i != m_RecvWidgets.end();)
   {
-    const QString &path = i->first;
+    const QString &path = OAT.Get(i->first).path;
     if (path.contains('*'))
     {
       ToyWidget *toy = i->second;
-      m_WildcardRecvWidgets.insert(Toy::RECV_WIDGETS_PAIR(path, toy));
+      m_WildcardRecvWidgets.insert(Toy::RECV_WIDGETS_PAIR(i->first, toy));
       m_RecvWidgets.erase(i++);
     }
     else
@@ -287,6 +452,80 @@ void Toys::BuildRecvWidgetsTable()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Toys::PrefetchImages(const QString &path)
+{
+  // trigger paths can name any image next to a trigger label's own, so decode
+  // those folders in the background and scale them for each trigger label
+  PixmapCache::sPrefetch prefetch;
+  for (TOY_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
+    (*i)->AddImagePrefetch(prefetch);
+
+  PMC.SetPrefetchSizes(prefetch.sizes);
+
+  QStringList dirs;
+  for (QStringList::const_iterator i = prefetch.triggerPaths.begin(); i != prefetch.triggerPaths.end(); i++)
+  {
+    QString dir(QFileInfo(*i).absolutePath());
+    if (!dirs.contains(dir))
+      dirs.push_back(dir);
+  }
+
+  // relative trigger paths resolve against the layout file
+  if (!prefetch.sizes.empty() && !path.isEmpty())
+  {
+    QString dir(QFileInfo(path).absolutePath());
+    if (!dirs.contains(dir))
+      dirs.push_back(dir);
+  }
+
+  QStringList nameFilters;
+  QList<QByteArray> formats(QImageReader::supportedImageFormats());
+  for (QList<QByteArray>::const_iterator i = formats.begin(); i != formats.end(); i++)
+    nameFilters.push_back(QString("*.%1").arg(QString::fromLatin1(*i)));
+
+  // referenced images first, they are the likeliest to be shown
+  QStringList files;
+  for (QStringList::const_iterator i = prefetch.paths.begin(); i != prefetch.paths.end() && files.size() < PREFETCH_MAX_IMAGES; i++)
+  {
+    if (!files.contains(*i))
+      files.push_back(*i);
+  }
+
+  for (QStringList::const_iterator i = dirs.begin(); i != dirs.end() && files.size() < PREFETCH_MAX_IMAGES; i++)
+  {
+    QDirIterator it(*i, nameFilters, QDir::Files | QDir::Readable);
+    while (it.hasNext() && files.size() < PREFETCH_MAX_IMAGES)
+    {
+      QString filePath(QDir::cleanPath(it.next()));
+      if (!files.contains(filePath))
+        files.push_back(filePath);
+    }
+  }
+
+  // leave the rest of the cache budget for what is actually drawn, so a large
+  // folder cannot evict it; sizes come from the image headers, nothing is decoded
+  qint64 budget = static_cast<qint64>(PMC.GetBudgetMB()) * 1024 * 1024 * PREFETCH_BUDGET_PERCENT / 100;
+  qint64 scaledPixels = 0;
+  for (PixmapCache::PREFETCH_SIZES::const_iterator i = prefetch.sizes.begin(); i != prefetch.sizes.end(); i++)
+    scaledPixels += qRound64(i->size.width() * i->dpr) * qRound64(i->size.height() * i->dpr);
+
+  qint64 bytes = 0;
+  for (QStringList::const_iterator i = files.begin(); i != files.end(); i++)
+  {
+    QSize size(QImageReader(*i).size());
+    if (!size.isValid())
+      continue;
+
+    bytes += (static_cast<qint64>(size.width()) * size.height() + scaledPixels) * 4;
+    if (bytes > budget)
+      break;
+
+    PMC.Prefetch(*i);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool Toys::Save(EosLog &log, const QString &path, QStringList &lines)
 {
   for (TOY_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
@@ -330,6 +569,7 @@ bool Toys::Load(EosLog &log, const QString &path, QStringList &lines, int &index
   }
 
   BuildRecvWidgetsTable();
+  PrefetchImages(path);
 
   return true;
 }
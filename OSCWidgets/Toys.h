@@ -34,7 +34,12 @@
 #include "Toy.h"
 #endif
 
+#ifndef NETWORK_THREADS_H
+#include "NetworkThreads.h"
+#endif
+
 #include <vector>
+#include <map>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -43,6 +48,12 @@ class Toys : public QObject
   Q_OBJECT
 
 public:
+  enum EnumConstants
+  {
+    PREFETCH_MAX_IMAGES = 200,
+    PREFETCH_BUDGET_PERCENT = 50
+  };
+
   typedef std::vector<Toy *> TOY_LIST;
 
   Toys(Toy::Client *pClient, QWidget *pParent);
@@ -59,6 +70,8 @@ public:
   virtual void SetOpacity(int opacity);
   virtual void ClearLabels();
   virtual void Recv(char *data, size_t len);
+  virtual void Recv(const PACKET_Q &packets);
+  virtual void Recv(OSCLocalMessage &msg);
   virtual bool Save(EosLog &log, const QString &path, QStringList &lines);
   virtual bool Load(EosLog &log, const QString &path, QStringList &lines, int &index);
   virtual void ActivateToy(size_t index);
@@ -81,6 +94,19 @@ private slots:
   void onToyToggledMainWindow();
 
 protected:
+  struct sRecvItem
+  {
+    ToyWidget *widget;
+    OSCAddressTable::ID pathId;
+    const OSCArgument *args;
+    size_t argCount;
+  };
+
+  typedef std::vector<sRecvItem> RECV_ITEMS;
+  typedef std::pair<ToyWidget *, OSCAddressTable::ID> RECV_ITEM_KEY;
+  typedef std::map<RECV_ITEM_KEY, size_t> RECV_ITEM_INDICIES;
+  typedef std::vector<OSCArgument *> RECV_ARGS;
+
   Toy::Client *m_pClient;
   QWidget *m_pParent;
   TOY_LIST m_List;
@@ -90,8 +116,16 @@ protected:
   Toy::RECV_WIDGETS m_RecvWidgets;
   Toy::RECV_WIDGETS m_WildcardRecvWidgets;
   bool m_Loading;
+  RECV_ITEMS m_RecvItems;
+  RECV_ITEM_INDICIES m_RecvItemIndicies;
+  RECV_ARGS m_RecvArgs;
 
   virtual void BuildRecvWidgetsTable();
+  virtual void PrefetchImages(const QString &path);
+  virtual bool RecvClock(const char *data, size_t len);
+  virtual bool RecvClock(const char *path, size_t pathLen, const OSCArgument *args, size_t argCount);
+  static bool IsClockPath(const char *path, size_t pathLen);
+  static OSCAddressTable::ID GetRecvPathId(const char *data, size_t len);
   virtual Qt::WindowFlags GetWindowFlags() const;
   virtual void UpdateWindowFlags();
 };
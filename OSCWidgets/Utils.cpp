@@ -19,10 +19,12 @@
 // THE SOFTWARE.
 
 #include "Utils.h"
+#include "OSCParser.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
 PixmapCache *PixmapCache::sm_Instance = 0;
+OSCAddressTable *OSCAddressTable::sm_Instance = 0;
 
 #ifdef WIN32
 
@@ -105,12 +107,353 @@ void Utils::GetItemsFromQuotedString(const QString &str, QStringList &items)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-PixmapCache::PixmapCache() {}
+void Utils::GetQuotedStringFromItems(const QStringList &items, QString &str)
+{
+  str.clear();
+  for (int i = 0; i < items.size(); i++)
+  {
+    if (i != 0)
+      str.append(", ");
+    str.append(QuotedString(items[i]));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCAddressTable::OSCAddressTable()
+{
+  m_List.push_back(sAddress());  // INVALID_ID
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCAddressTable::ID OSCAddressTable::Intern(const QString &path)
+{
+  if (path.isEmpty())
+    return INVALID_ID;
+
+  PATH_IDS::const_iterator i = m_PathIds.constFind(path);
+  if (i != m_PathIds.constEnd())
+  {
+    m_List[i.value()].refs++;
+    return i.value();
+  }
+
+  ID id = INVALID_ID;
+  if (m_FreeIds.empty())
+  {
+    id = static_cast<ID>(m_List.size());
+    m_List.push_back(sAddress());
+  }
+  else
+  {
+    id = m_FreeIds.back();
+    m_FreeIds.pop_back();
+  }
+
+  sAddress &address = m_List[id];
+  address.path = path;
+  QString oscPath(path);
+  address.local = Utils::MakeLocalOSCPath(false, oscPath);
+  address.utf8 = oscPath.toUtf8();
+  address.encoded = address.utf8;
+  OSCPacketTemplate::AppendPadding(address.encoded);
+  address.refs = 1;
+
+  m_PathIds.insert(path, id);
+
+  // only plain addresses can be the destination of a received message
+  if (!address.local && !m_RecvIds.contains(address.utf8))
+    m_RecvIds.insert(address.utf8, id);
+
+  return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCAddressTable::Release(ID id)
+{
+  if (id == INVALID_ID || id >= m_List.size())
+    return;
+
+  sAddress &address = m_List[id];
+  if (address.refs == 0 || --address.refs != 0)
+    return;
+
+  m_PathIds.remove(address.path);
+
+  RECV_IDS::iterator i = m_RecvIds.find(address.utf8);
+  if (i != m_RecvIds.end() && i.value() == id)
+    m_RecvIds.erase(i);
+
+  address = sAddress();
+  m_FreeIds.push_back(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCAddressTable::ID OSCAddressTable::Find(const char *utf8, size_t len) const
+{
+  if (!utf8 || len == 0)
+    return INVALID_ID;
+
+  // wraps the packet bytes without copying them
+  return m_RecvIds.value(QByteArray::fromRawData(utf8, static_cast<int>(len)), INVALID_ID);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCAddressTable::ID OSCAddressTable::FindPath(const QString &path) const
+{
+  return m_PathIds.value(path, INVALID_ID);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const OSCAddressTable::sAddress &OSCAddressTable::Get(ID id) const
+{
+  return ((id < m_List.size()) ? m_List[id] : m_List[INVALID_ID]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCAddressTable::Instantiate()
+{
+  if (!sm_Instance)
+    sm_Instance = new OSCAddressTable();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCAddressTable::Shutdown()
+{
+  if (sm_Instance)
+  {
+    delete sm_Instance;
+    sm_Instance = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCPacketTemplate::OSCPacketTemplate()
+  : m_FloatCount(0)
+  , m_Local(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCPacketTemplate::Clear()
+{
+  m_Header.clear();
+  m_Address.clear();
+  m_FloatCount = 0;
+  m_Local = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCPacketTemplate::AppendPadding(QByteArray &ba)
+{
+  // OSC strings are null terminated, and padded to a multiple of 4 bytes
+  int padding = (4 - (ba.size() % 4));
+  ba.append(padding, '\0');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OSCPacketTemplate::Build(OSCAddressTable::ID pathId, size_t floatCount)
+{
+  const OSCAddressTable::sAddress &address = OAT.Get(pathId);
+  m_Local = address.local;
+  m_FloatCount = floatCount;
+
+  m_Address = address.utf8;
+  m_Header = address.encoded;
+  m_Header.append(',');
+  m_Header.append(static_cast<int>(floatCount), 'f');
+  AppendPadding(m_Header);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+char *OSCPacketTemplate::Create(const float *values, size_t count, size_t &size) const
+{
+  if (m_Header.isEmpty() || count != m_FloatCount || (count != 0 && !values))
+  {
+    size = 0;
+    return 0;
+  }
+
+  size_t headerSize = static_cast<size_t>(m_Header.size());
+  size = (headerSize + count * 4);
+
+  char *packet = new char[size];
+  memcpy(packet, m_Header.constData(), headerSize);
+
+  char *arg = (packet + headerSize);
+  for (size_t i = 0; i < count; i++, arg += 4)
+  {
+    quint32 bits = 0;
+    memcpy(&bits, &values[i], 4);
+    qToBigEndian(bits, arg);
+  }
+
+  return packet;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCPacketTemplate::CreateLocal(const float *values, size_t count, OSCLocalMessage &msg) const
+{
+  if (m_Header.isEmpty() || count != m_FloatCount || (count != 0 && !values))
+    return false;
+
+  msg = OSCLocalMessage(m_Address);
+  for (size_t i = 0; i < count; i++)
+  {
+    if (!msg.AddFloat32(values[i]))
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCLocalMessage::OSCLocalMessage()
+  : m_ArgCount(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OSCLocalMessage::OSCLocalMessage(const QByteArray &address)
+  : m_Address(address)
+  , m_ArgCount(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCLocalMessage::AddFloat32(float f)
+{
+  if (m_ArgCount >= MAX_ARGS)
+    return false;
+
+  sArg &arg = m_Args[m_ArgCount++];
+  arg.isString = false;
+  arg.offset = m_Data.size();
+  arg.size = 4;
+
+  quint32 bits = 0;
+  memcpy(&bits, &f, 4);
+  char buf[4];
+  qToBigEndian(bits, buf);
+  m_Data.append(buf, 4);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool OSCLocalMessage::AddString(const QByteArray &str)
+{
+  if (m_ArgCount >= MAX_ARGS)
+    return false;
+
+  sArg &arg = m_Args[m_ArgCount++];
+  arg.isString = true;
+  arg.offset = m_Data.size();
+  arg.size = (str.size() + 1);
+
+  QByteArray padded(str);
+  OSCPacketTemplate::AppendPadding(padded);
+  m_Data.append(padded);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+size_t OSCLocalMessage::GetArgs(OSCArgument *args, size_t maxCount)
+{
+  size_t count = qMin(m_ArgCount, maxCount);
+  if (count == 0 || !args)
+    return 0;
+
+  char *data = m_Data.data();
+  for (size_t i = 0; i < count; i++)
+  {
+    const sArg &arg = m_Args[i];
+    args[i].Init(arg.isString ? OSCArgument::OSC_TYPE_STRING : OSCArgument::OSC_TYPE_FLOAT32, data + arg.offset, static_cast<size_t>(arg.size));
+  }
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// decodes an image file, or scales an already decoded one, off the gui thread
+class PixmapCacheJob : public QRunnable
+{
+public:
+  PixmapCacheJob(PixmapCache *pCache, const QString &path)
+    : m_pCache(pCache)
+    , m_Path(path)
+  {
+  }
+
+  PixmapCacheJob(PixmapCache *pCache, const QString &key, const QImage &image, const QSize &size)
+    : m_pCache(pCache)
+    , m_Key(key)
+    , m_Image(image)
+    , m_Size(size)
+  {
+  }
+
+  virtual void run()
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_Key.isEmpty())
+    {
+      QImage image(m_Path);
+      QMetaObject::invokeMethod(m_pCache, "onDecoded", Qt::QueuedConnection, Q_ARG(QString, m_Path), Q_ARG(QImage, image), Q_ARG(qint64, timer.nsecsElapsed()));
+    }
+    else
+    {
+      QImage scaled(m_Image.scaled(m_Size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+      QMetaObject::invokeMethod(m_pCache, "onScaled", Qt::QueuedConnection, Q_ARG(QString, m_Key), Q_ARG(QImage, scaled), Q_ARG(qint64, timer.nsecsElapsed()));
+    }
+  }
+
+private:
+  PixmapCache *m_pCache;
+  QString m_Path;
+  QString m_Key;
+  QImage m_Image;
+  QSize m_Size;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+PixmapCache::PixmapCache()
+  : m_OriginalBytes(0)
+  , m_ScaledBytes(0)
+  , m_BudgetBytes(static_cast<qint64>(DEFAULT_BUDGET_MB) * 1024 * 1024)
+  , m_UseCounter(0)
+{
+  // leave a core for the gui, generator and network threads
+  m_Pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 PixmapCache::~PixmapCache()
 {
+  m_Pool.clear();
+  m_Pool.waitForDone();
   Clear();
 }
 
@@ -118,28 +461,66 @@ PixmapCache::~PixmapCache()
 
 void PixmapCache::Clear()
 {
-  for (PIXMAP_LIST::const_iterator i = m_List.begin(); i != m_List.end(); i++)
-    delete i->second.pixmap;
   m_List.clear();
+  m_Scaled.clear();
+  m_OriginalBytes = 0;
+  m_ScaledBytes = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::SetBudgetMB(unsigned int n)
+{
+  m_BudgetBytes = (static_cast<qint64>(qBound(1u, n, static_cast<unsigned int>(MAX_BUDGET_MB))) * 1024 * 1024);
+  Evict(QString());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const QPixmap *PixmapCache::Create(const QString &path)
+void PixmapCache::Create(const QString &path)
 {
   if (path.isEmpty())
-    return 0;
+    return;
 
   PIXMAP_LIST::iterator i = m_List.find(path);
   if (i == m_List.end())
   {
-    sPixmapCacheItem item = {new QPixmap(path), 1};
-    m_List[path] = item;
-    return item.pixmap;
+    m_Stats.misses++;
+    sPixmapCacheItem &item = m_List[path];
+    item.refCount = 1;
+    item.lastUsed = ++m_UseCounter;
+    m_Pool.start(new PixmapCacheJob(this, path));
+  }
+  else
+  {
+    m_Stats.hits++;
+    i->second.refCount++;
+    i->second.prefetch = false;
+    i->second.lastUsed = ++m_UseCounter;
   }
+}
 
-  i->second.refCount++;
-  return i->second.pixmap;
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::Prefetch(const QString &path)
+{
+  if (path.isEmpty())
+    return;
+
+  PIXMAP_LIST::iterator i = m_List.find(path);
+  if (i == m_List.end())
+  {
+    // no reference, so an unused prefetch is the first thing evicted
+    m_Stats.prefetches++;
+    sPixmapCacheItem &item = m_List[path];
+    item.prefetch = true;
+    item.lastUsed = ++m_UseCounter;
+    m_Pool.start(new PixmapCacheJob(this, path), PREFETCH_PRIORITY);
+  }
+  else if (i->second.pending)
+    i->second.prefetch = true;
+  else
+    PrefetchScaled(path, i->second.image);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -149,15 +530,16 @@ void PixmapCache::Destroy(const QString &path)
   if (!path.isEmpty())
   {
     PIXMAP_LIST::iterator i = m_List.find(path);
-    if (i != m_List.end())
+    if (i != m_List.end() && i->second.refCount != 0)
     {
-      if (i->second.refCount != 0)
-        i->second.refCount--;
-
-      if (i->second.refCount == 0)
+      // unreferenced images stay cached until the budget needs the room, except
+      // failed decodes, since the file may still turn up
+      if (--i->second.refCount == 0)
       {
-        delete i->second.pixmap;
-        m_List.erase(i);
+        if (!i->second.pending && i->second.image.isNull())
+          m_List.erase(i);
+        else
+          Evict(QString());
       }
     }
   }
@@ -165,54 +547,225 @@ void PixmapCache::Destroy(const QString &path)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-const QPixmap *PixmapCache::Get(const QString &path) const
+bool PixmapCache::IsPending(const QString &path) const
 {
   PIXMAP_LIST::const_iterator i = m_List.find(path);
-  return ((i == m_List.end()) ? 0 : i->second.pixmap);
+  return (i != m_List.end() && i->second.pending);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void PixmapCache::Get(const QString &path, QPixmap &pixmap) const
+bool PixmapCache::Get(const QString &path, QPixmap &pixmap) const
 {
-  const QPixmap *p = Get(path);
-  pixmap = (p ? (*p) : QPixmap());
+  PIXMAP_LIST::const_iterator i = m_List.find(path);
+  if (i != m_List.end() && !i->second.pending)
+  {
+    pixmap = QPixmap::fromImage(i->second.image);
+    return true;
+  }
+
+  pixmap = QPixmap();
+  return (i == m_List.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void PixmapCache::GetScaledToFit(const QString &path, const QSize &size, QPixmap &pixmap) const
+bool PixmapCache::GetScaledToFit(const QString &path, const QSize &size, QPixmap &pixmap) const
 {
-  const QPixmap *p = Get(path);
-  if (p && !p->isNull() && !size.isEmpty())
+  pixmap = QPixmap();
+
+  PIXMAP_LIST::const_iterator i = m_List.find(path);
+  if (i == m_List.end())
+    return true;
+
+  if (i->second.pending)
+    return false;
+
+  const QImage &image = i->second.image;
+  if (!image.isNull() && !size.isEmpty())
   {
-    QRect r(0, 0, p->width(), p->height());
+    QRect r(0, 0, image.width(), image.height());
     if (FitRectInBounds(QRect(0, 0, size.width(), size.height()), Qt::AlignCenter, r))
-      pixmap = p->scaled(r.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+      pixmap = QPixmap::fromImage(image.scaled(r.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool PixmapCache::GetScaledToFill(const QString &path, const QSize &size, qreal dpr, QPixmap &pixmap)
+{
+  // returns false while the result is still being decoded or scaled; ready(path) follows
+  pixmap = QPixmap();
+
+  PIXMAP_LIST::iterator i = m_List.find(path);
+  if (i == m_List.end() || size.isEmpty())
+    return true;
+
+  i->second.lastUsed = ++m_UseCounter;
+
+  if (i->second.pending)
+    return false;
+
+  const QImage &image = i->second.image;
+  if (image.isNull())
+    return true;
+
+  if (dpr <= 0)
+    dpr = 1;
+
+  QString key(GetScaledKey(path, size, dpr));
+  SCALED_LIST::iterator j = m_Scaled.find(key);
+  if (j != m_Scaled.end())
+  {
+    m_Stats.hits++;
+    j->second.lastUsed = m_UseCounter;
+    pixmap = j->second.pixmap;
+    return !j->second.pending;
+  }
+
+  m_Stats.misses++;
+  sScaledItem &item = m_Scaled[key];
+  item.path = path;
+  item.dpr = dpr;
+  item.lastUsed = m_UseCounter;
+  m_Pool.start(new PixmapCacheJob(this, key, image, GetFillSize(image.size(), size * dpr)));
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::RemoveOriginal(PIXMAP_LIST::iterator i)
+{
+  const QString &path = i->first;
+  for (SCALED_LIST::iterator j = m_Scaled.begin(); j != m_Scaled.end();)
+  {
+    if (j->second.path == path)
+      RemoveScaled(j++);
     else
-      pixmap = QPixmap();
+      j++;
   }
-  else
-    pixmap = QPixmap();
+
+  m_OriginalBytes -= i->second.image.sizeInBytes();
+  m_List.erase(i);
+  m_Stats.evictions++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::RemoveScaled(SCALED_LIST::iterator i)
+{
+  m_ScaledBytes -= GetPixmapBytes(i->second.pixmap);
+  m_Scaled.erase(i);
+  m_Stats.evictions++;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void PixmapCache::GetScaledToFill(const QString &path, const QSize &size, QPixmap &pixmap) const
+void PixmapCache::Evict(const QString &keepKey)
 {
-  const QPixmap *p = Get(path);
-  if (p && !p->isNull() && !size.isEmpty())
+  // least recently used first, unreferenced originals (with their scaled copies) before scaled copies still in use;
+  // those widgets hold their own implicitly shared copy, and referenced originals are kept to scale new sizes from
+  while ((m_OriginalBytes + m_ScaledBytes) > m_BudgetBytes)
   {
-    // scale to bounds width
-    float t = (size.width() / static_cast<float>(p->width()));
-    int h = qRound(p->height() * t);
-    if (h < size.height())
-      t = (size.height() / static_cast<float>(p->height()));
+    PIXMAP_LIST::iterator lruOriginal = m_List.end();
+    for (PIXMAP_LIST::iterator i = m_List.begin(); i != m_List.end(); i++)
+    {
+      if (i->second.refCount == 0 && !i->second.pending && (lruOriginal == m_List.end() || i->second.lastUsed < lruOriginal->second.lastUsed))
+        lruOriginal = i;
+    }
 
-    pixmap = p->scaled(QSize(qRound(p->width() * t), qRound(p->height() * t)), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    if (lruOriginal != m_List.end())
+    {
+      RemoveOriginal(lruOriginal);
+      continue;
+    }
+
+    SCALED_LIST::iterator lruScaled = m_Scaled.end();
+    for (SCALED_LIST::iterator i = m_Scaled.begin(); i != m_Scaled.end(); i++)
+    {
+      if (!i->second.pending && i->first != keepKey && (lruScaled == m_Scaled.end() || i->second.lastUsed < lruScaled->second.lastUsed))
+        lruScaled = i;
+    }
+
+    if (lruScaled == m_Scaled.end())
+      break;
+
+    RemoveScaled(lruScaled);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::PrefetchScaled(const QString &path, const QImage &image)
+{
+  if (image.isNull())
+    return;
+
+  for (PREFETCH_SIZES::const_iterator i = m_PrefetchSizes.begin(); i != m_PrefetchSizes.end(); i++)
+  {
+    QString key(GetScaledKey(path, i->size, i->dpr));
+    if (m_Scaled.find(key) == m_Scaled.end())
+    {
+      sScaledItem &item = m_Scaled[key];
+      item.path = path;
+      item.dpr = i->dpr;
+      item.lastUsed = ++m_UseCounter;
+      m_Pool.start(new PixmapCacheJob(this, key, image, GetFillSize(image.size(), i->size * i->dpr)), PREFETCH_PRIORITY);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::onDecoded(const QString &path, const QImage &image, qint64 elapsedNS)
+{
+  m_Stats.decodes++;
+  m_Stats.decodeNS += elapsedNS;
+  if (elapsedNS > m_Stats.maxDecodeNS)
+    m_Stats.maxDecodeNS = elapsedNS;
+
+  PIXMAP_LIST::iterator i = m_List.find(path);
+  if (i != m_List.end() && i->second.pending)
+  {
+    i->second.image = image;
+    i->second.pending = false;
+    m_OriginalBytes += image.sizeInBytes();
+    bool prefetch = i->second.prefetch;
+    Evict(QString());
+    emit ready(path);
+
+    if (prefetch)
+    {
+      i = m_List.find(path);
+      if (i != m_List.end())
+        PrefetchScaled(path, i->second.image);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::onScaled(const QString &key, const QImage &image, qint64 elapsedNS)
+{
+  m_Stats.scales++;
+  m_Stats.scaleNS += elapsedNS;
+
+  SCALED_LIST::iterator i = m_Scaled.find(key);
+  if (i != m_Scaled.end() && i->second.pending)
+  {
+    QPixmap pixmap(QPixmap::fromImage(image));
+    pixmap.setDevicePixelRatio(i->second.dpr);
+
+    i->second.pixmap = pixmap;
+    i->second.pending = false;
+    m_ScaledBytes += GetPixmapBytes(pixmap);
+
+    QString path(i->second.path);
+    Evict(key);
+    emit ready(path);
   }
-  else
-    pixmap = QPixmap();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -236,6 +789,58 @@ void PixmapCache::Shutdown()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+QSize PixmapCache::GetFillSize(const QSize &imageSize, const QSize &size)
+{
+  if (imageSize.isEmpty() || size.isEmpty())
+    return QSize();
+
+  // scale to bounds width
+  float t = (size.width() / static_cast<float>(imageSize.width()));
+  int h = qRound(imageSize.height() * t);
+  if (h < size.height())
+    t = (size.height() / static_cast<float>(imageSize.height()));
+
+  return QSize(qRound(imageSize.width() * t), qRound(imageSize.height() * t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QString PixmapCache::GetScaledKey(const QString &path, const QSize &size, qreal dpr)
+{
+  return (path + QStringLiteral(":%1x%2@%3").arg(size.width()).arg(size.height()).arg(dpr));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PixmapCache::AddPrefetchSize(const QSize &size, qreal dpr, PREFETCH_SIZES &sizes)
+{
+  if (size.isEmpty())
+    return;
+
+  if (dpr <= 0)
+    dpr = 1;
+
+  for (PREFETCH_SIZES::const_iterator i = sizes.begin(); i != sizes.end(); i++)
+  {
+    if (i->size == size && i->dpr == dpr)
+      return;
+  }
+
+  sPrefetchSize prefetchSize;
+  prefetchSize.size = size;
+  prefetchSize.dpr = dpr;
+  sizes.push_back(prefetchSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 PixmapCache::GetPixmapBytes(const QPixmap &pixmap)
+{
+  return ((static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth()) / 8);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool PixmapCache::FitRectInBounds(const QRect &bounds, Qt::Alignment alignment, QRect &r)
 {
   if (!bounds.size().isEmpty() && !r.size().isEmpty())
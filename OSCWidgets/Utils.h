@@ -30,7 +30,12 @@
 #include <Windows.h>
 #endif
 
+#include <deque>
 #include <map>
+#include <vector>
+
+class OSCArgument;
+class OSCLocalMessage;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -41,6 +46,7 @@ public:
   static bool IsLocalOSCPath(const QString &path);
   static bool MakeLocalOSCPath(bool b, QString &path);
   static void GetItemsFromQuotedString(const QString &str, QStringList &items);
+  static void GetQuotedStringFromItems(const QStringList &items, QString &str);
   static void BlockFakeMouseEvents(bool b);
   static void RegisterTouchWidget(QWidget &widget);
   static bool IsBrightColor(const QColor &color);
@@ -61,36 +67,282 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class PixmapCache
+// process-wide table of every OSC address used by the loaded widgets, so sends and
+// receive dispatch work with stable ids instead of converting QStrings per message.
+// Intern adds a reference that the holder gives back with Release; once the last one
+// is gone the entry is cleared and its id handed to the next new address.
+class OSCAddressTable
+{
+public:
+  typedef unsigned int ID;
+
+  enum EnumConstants
+  {
+    INVALID_ID = 0
+  };
+
+  struct sAddress
+  {
+    sAddress()
+      : local(false)
+      , refs(0)
+    {
+    }
+    QString path;        // as entered, including any local prefix
+    QByteArray utf8;     // local prefix removed
+    QByteArray encoded;  // utf8, null terminated and padded for OSC
+    bool local;
+    unsigned int refs;
+  };
+
+  OSCAddressTable();
+  virtual ~OSCAddressTable() {}
+
+  virtual ID Intern(const QString &path);
+  virtual void Release(ID id);
+  virtual ID Find(const char *utf8, size_t len) const;
+  virtual ID FindPath(const QString &path) const;
+  // entries never move, but one whose last reference is released is cleared and may be
+  // reused, so copy anything needed across code that can intern or release
+  virtual const sAddress &Get(ID id) const;
+  virtual size_t GetCount() const { return static_cast<size_t>(m_PathIds.size()); }
+
+  static void Instantiate();
+  static void Shutdown();
+  static OSCAddressTable &Instance() { return *sm_Instance; }
+
+protected:
+  typedef std::deque<sAddress> ADDRESS_LIST;
+  typedef std::vector<ID> FREE_IDS;
+  typedef QHash<QString, ID> PATH_IDS;
+  typedef QHash<QByteArray, ID> RECV_IDS;
+
+  ADDRESS_LIST m_List;
+  FREE_IDS m_FreeIds;
+  PATH_IDS m_PathIds;
+  RECV_IDS m_RecvIds;
+
+  static OSCAddressTable *sm_Instance;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define OAT OSCAddressTable::Instance()
+
+////////////////////////////////////////////////////////////////////////////////
+
+// pre-encoded OSC address and type tags for a path that only ever sends float32 arguments,
+// so hot sends just append argument bytes rather than re-encoding the whole message
+class OSCPacketTemplate
+{
+public:
+  OSCPacketTemplate();
+  virtual ~OSCPacketTemplate() {}
+
+  virtual void Clear();
+  virtual bool IsEmpty() const { return m_Header.isEmpty(); }
+  virtual void Build(OSCAddressTable::ID pathId, size_t floatCount);
+  virtual bool GetLocal() const { return m_Local; }
+  virtual size_t GetFloatCount() const { return m_FloatCount; }
+  virtual char *Create(const float *values, size_t count, size_t &size) const;
+  virtual bool CreateLocal(const float *values, size_t count, OSCLocalMessage &msg) const;
+
+  static void AppendPadding(QByteArray &ba);
+
+protected:
+  QByteArray m_Header;
+  QByteArray m_Address;
+  size_t m_FloatCount;
+  bool m_Local;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// an already typed message between widgets in this process, so local sends are never
+// serialized into an OSC packet just to have the address and arguments parsed back out
+class OSCLocalMessage
 {
 public:
+  enum EnumConstants
+  {
+    MAX_ARGS = 4
+  };
+
+  OSCLocalMessage();
+  OSCLocalMessage(const QByteArray &address);
+  virtual ~OSCLocalMessage() {}
+
+  virtual const QByteArray &GetAddress() const { return m_Address; }
+  virtual size_t GetArgCount() const { return m_ArgCount; }
+  virtual bool AddFloat32(float f);
+  virtual bool AddString(const QByteArray &str);
+  // the arguments point into this message, so only use them while it is unchanged
+  virtual size_t GetArgs(OSCArgument *args, size_t maxCount);
+
+protected:
+  struct sArg
+  {
+    bool isString;
+    int offset;
+    int size;
+  };
+
+  QByteArray m_Address;  // utf8, local prefix removed
+  QByteArray m_Data;     // argument values, laid out as in an OSC packet
+  sArg m_Args[MAX_ARGS];
+  size_t m_ArgCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// shared images by path, plus scaled copies keyed by path, size and device pixel ratio
+// decoding and scaling run on a worker pool, so lookups return nothing until ready() is emitted
+// originals and scaled copies share one byte budget, evicted least recently used first
+// prefetched images are decoded at low priority without a reference, ready for a later Create
+class PixmapCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  enum EnumConstants
+  {
+    DEFAULT_BUDGET_MB = 128,
+    MAX_BUDGET_MB = 4096,
+    PREFETCH_PRIORITY = -1
+  };
+
   struct sPixmapCacheItem
   {
-    const QPixmap *pixmap;
+    sPixmapCacheItem()
+      : refCount(0)
+      , pending(true)
+      , prefetch(false)
+      , lastUsed(0)
+    {
+    }
+    QImage image;  // decoded original, shared read-only with scaling jobs
     unsigned int refCount;
+    bool pending;
+    bool prefetch;
+    quint64 lastUsed;
+  };
+
+  struct sScaledItem
+  {
+    sScaledItem()
+      : dpr(1)
+      , pending(true)
+      , lastUsed(0)
+    {
+    }
+    QString path;
+    QPixmap pixmap;
+    qreal dpr;
+    bool pending;
+    quint64 lastUsed;
+  };
+
+  struct sStats
+  {
+    sStats()
+      : hits(0)
+      , misses(0)
+      , decodes(0)
+      , decodeNS(0)
+      , maxDecodeNS(0)
+      , scales(0)
+      , scaleNS(0)
+      , evictions(0)
+      , prefetches(0)
+    {
+    }
+    quint64 hits;
+    quint64 misses;
+    unsigned int decodes;
+    qint64 decodeNS;
+    qint64 maxDecodeNS;
+    unsigned int scales;
+    qint64 scaleNS;
+    unsigned int evictions;
+    unsigned int prefetches;
+  };
+
+  struct sPrefetchSize
+  {
+    sPrefetchSize()
+      : dpr(1)
+    {
+    }
+    QSize size;
+    qreal dpr;
+  };
+
+  typedef std::vector<sPrefetchSize> PREFETCH_SIZES;
+
+  struct sPrefetch
+  {
+    QStringList paths;
+    QStringList triggerPaths;
+    PREFETCH_SIZES sizes;
   };
 
   typedef std::map<QString, sPixmapCacheItem> PIXMAP_LIST;
+  typedef std::map<QString, sScaledItem> SCALED_LIST;
 
   PixmapCache();
   virtual ~PixmapCache();
 
   virtual void Clear();
-  virtual const QPixmap *Create(const QString &path);
-  virtual const QPixmap *Get(const QString &path) const;
+  virtual void Create(const QString &path);
   virtual void Destroy(const QString &path);
+  virtual bool IsPending(const QString &path) const;
   virtual const PIXMAP_LIST &GetList() const { return m_List; }
-  virtual void Get(const QString &path, QPixmap &pixmap) const;
-  virtual void GetScaledToFit(const QString &path, const QSize &size, QPixmap &pixmap) const;
-  virtual void GetScaledToFill(const QString &path, const QSize &size, QPixmap &pixmap) const;
+  virtual bool Get(const QString &path, QPixmap &pixmap) const;
+  virtual bool GetScaledToFit(const QString &path, const QSize &size, QPixmap &pixmap) const;
+  virtual bool GetScaledToFill(const QString &path, const QSize &size, qreal dpr, QPixmap &pixmap);
+  virtual unsigned int GetBudgetMB() const { return static_cast<unsigned int>(m_BudgetBytes / (1024 * 1024)); }
+  virtual void SetBudgetMB(unsigned int n);
+  virtual qint64 GetOriginalBytes() const { return m_OriginalBytes; }
+  virtual qint64 GetScaledBytes() const { return m_ScaledBytes; }
+  virtual const SCALED_LIST &GetScaledList() const { return m_Scaled; }
+  virtual const sStats &GetStats() const { return m_Stats; }
+  virtual void ResetStats() { m_Stats = sStats(); }
+  virtual void Prefetch(const QString &path);
+  virtual const PREFETCH_SIZES &GetPrefetchSizes() const { return m_PrefetchSizes; }
+  virtual void SetPrefetchSizes(const PREFETCH_SIZES &sizes) { m_PrefetchSizes = sizes; }
 
   static void Instantiate();
   static void Shutdown();
   static PixmapCache &Instance() { return *sm_Instance; }
   static bool FitRectInBounds(const QRect &bounds, Qt::Alignment alignment, QRect &r);
+  static QSize GetFillSize(const QSize &imageSize, const QSize &size);
+  static qint64 GetPixmapBytes(const QPixmap &pixmap);
+  static void AddPrefetchSize(const QSize &size, qreal dpr, PREFETCH_SIZES &sizes);
+
+signals:
+  void ready(const QString &path);
+
+private slots:
+  void onDecoded(const QString &path, const QImage &image, qint64 elapsedNS);
+  void onScaled(const QString &key, const QImage &image, qint64 elapsedNS);
 
 protected:
   PIXMAP_LIST m_List;
+  SCALED_LIST m_Scaled;
+  qint64 m_OriginalBytes;
+  qint64 m_ScaledBytes;
+  qint64 m_BudgetBytes;
+  quint64 m_UseCounter;
+  sStats m_Stats;
+  PREFETCH_SIZES m_PrefetchSizes;
+  QThreadPool m_Pool;
+
+  virtual void RemoveOriginal(PIXMAP_LIST::iterator i);
+  virtual void RemoveScaled(SCALED_LIST::iterator i);
+  virtual void Evict(const QString &keepKey);
+  virtual void PrefetchScaled(const QString &path, const QImage &image);
+
+  static QString GetScaledKey(const QString &path, const QSize &size, qreal dpr);
 
   static PixmapCache *sm_Instance;
 };
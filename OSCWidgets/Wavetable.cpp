@@ -0,0 +1,112 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "Wavetable.h"
+#include "QtInclude.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+const float Wavetable::MAX_SINE_ERROR = 0.000001f;
+float Wavetable::sm_Tables[WAVEFORM_COUNT][TABLE_SIZE + 1];
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Wavetable::Init()
+{
+  // fixed seed, so random-smooth has the same shape every run
+  quint32 seed = 0x9e3779b9;
+  float points[RANDOM_POINTS];
+  for (int i = 0; i < RANDOM_POINTS; i++)
+  {
+    seed = (seed * 1664525 + 1013904223);
+    points[i] = ((seed >> 8) / 16777216.0f);
+  }
+
+  for (int i = 0; i <= TABLE_SIZE; i++)
+  {
+    double t = (i / static_cast<double>(TABLE_SIZE));
+
+    sm_Tables[WAVEFORM_SINE][i] = static_cast<float>((sin(t * TWO_PI) + 1) * 0.5);
+    sm_Tables[WAVEFORM_TRIANGLE][i] = static_cast<float>((t < 0.5) ? (t * 2) : (2 - t * 2));
+    sm_Tables[WAVEFORM_SAW][i] = static_cast<float>(t);
+    sm_Tables[WAVEFORM_SQUARE][i] = ((t < 0.5) ? 1.0f : 0.0f);
+
+    // cosine-eased between random points, wrapping around the cycle
+    double p = (t * RANDOM_POINTS);
+    int index = (static_cast<int>(p) % RANDOM_POINTS);
+    double f = ((1 - cos((p - floor(p)) * M_PI)) * 0.5);
+    float a = points[index];
+    float b = points[(index + 1) % RANDOM_POINTS];
+    sm_Tables[WAVEFORM_RANDOM][i] = static_cast<float>(a + (b - a) * f);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+float Wavetable::Lookup(EnumWaveform waveform, double cycles, float duty)
+{
+  double t = (cycles - floor(cycles));
+
+  // duty skews the cycle so the first half of the shape takes up duty of the period
+  if (duty != 0.5f && duty > 0 && duty < 1)
+    t = ((t < duty) ? (0.5 * t / duty) : (0.5 + 0.5 * (t - duty) / (1 - duty)));
+
+  double x = (t * TABLE_SIZE);
+  int index = static_cast<int>(x);
+  if (index >= TABLE_SIZE)
+    index = (TABLE_SIZE - 1);
+  float f = static_cast<float>(x - index);
+
+  const float *table = sm_Tables[(waveform >= 0 && waveform < WAVEFORM_COUNT) ? waveform : WAVEFORM_SINE];
+  return (table[index] + (table[index + 1] - table[index]) * f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const char *Wavetable::GetName(EnumWaveform waveform)
+{
+  switch (waveform)
+  {
+    case WAVEFORM_SINE: return "sine";
+    case WAVEFORM_TRIANGLE: return "triangle";
+    case WAVEFORM_SAW: return "saw";
+    case WAVEFORM_SQUARE: return "square";
+    case WAVEFORM_RANDOM: return "random";
+    case WAVEFORM_COUNT: break;
+  }
+
+  return "sine";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Wavetable::EnumWaveform Wavetable::GetWaveformForName(const QString &name)
+{
+  for (int i = 0; i < WAVEFORM_COUNT; i++)
+  {
+    EnumWaveform waveform = static_cast<EnumWaveform>(i);
+    if (name.compare(QLatin1String(GetName(waveform)), Qt::CaseInsensitive) == 0)
+      return waveform;
+  }
+
+  return WAVEFORM_SINE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
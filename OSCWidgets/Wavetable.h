@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#ifndef TOY_MATH_H
+#include "ToyMath.h"
+#endif
+
+class QString;
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Precomputed single-cycle LFO shapes shared by every generator, normalized to 0..1.
+// Lookups interpolate linearly; the sine table is within MAX_SINE_ERROR of (sin(x)+1)/2.
+class Wavetable
+{
+public:
+  enum EnumWaveform
+  {
+    WAVEFORM_SINE,
+    WAVEFORM_TRIANGLE,
+    WAVEFORM_SAW,
+    WAVEFORM_SQUARE,
+    WAVEFORM_RANDOM,
+
+    WAVEFORM_COUNT
+  };
+
+  enum EnumConstants
+  {
+    TABLE_BITS = 11,
+    TABLE_SIZE = (1 << TABLE_BITS),
+    RANDOM_POINTS = 16
+  };
+
+  static const float MAX_SINE_ERROR;
+
+  static void Init();
+  static float Lookup(EnumWaveform waveform, double cycles, float duty);
+  static inline float LookupSine(double cycles);
+  static const char *GetName(EnumWaveform waveform);
+  static EnumWaveform GetWaveformForName(const QString &name);
+
+private:
+  // one guard sample past the end so interpolation never wraps
+  static float sm_Tables[WAVEFORM_COUNT][TABLE_SIZE + 1];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// the plain sine at even duty, without branches; a position rounding up to the end
+// of the cycle wraps onto the first sample, which holds the same value
+inline float Wavetable::LookupSine(double cycles)
+{
+  double x = ((cycles - floor(cycles)) * TABLE_SIZE);
+  int index = static_cast<int>(x);
+  float f = static_cast<float>(x - index);
+  index &= (TABLE_SIZE - 1);
+
+  const float *table = sm_Tables[WAVEFORM_SINE];
+  return (table[index] + (table[index + 1] - table[index]) * f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
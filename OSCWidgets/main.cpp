@@ -20,19 +20,19 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include "EosTimer.h"
 #include "QtInclude.h"
 #include "MainWindow.h"
 #include "Utils.h"
+#include "FrameScheduler.h"
+#include "GeneratorThread.h"
+#include "Wavetable.h"
 #include "EosPlatform.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char *argv[])
 {
-  srand(static_cast<unsigned int>(time(0)));
-
   EosTimer::Init();
 
   EosPlatform *platform = EosPlatform::Create();
@@ -95,13 +95,23 @@ int main(int argc, char *argv[])
   QFont fnt("Roboto", 10);
   app.setFont(fnt);
 
+  // room for the pre-rendered button background layers of large grids
+  QPixmapCache::setCacheLimit(64 * 1024);
+
   PixmapCache::Instantiate();
+  OSCAddressTable::Instantiate();
+  FrameScheduler::Instantiate();
+  Wavetable::Init();
+  GeneratorThread::Instantiate();
 
   MainWindow *mainWindow = new MainWindow(platform);
   mainWindow->show();
   int result = app.exec();
   delete mainWindow;
 
+  GeneratorThread::Shutdown();
+  FrameScheduler::Shutdown();
+  OSCAddressTable::Shutdown();
   PixmapCache::Shutdown();
 
   if (platform)
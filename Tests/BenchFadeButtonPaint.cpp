@@ -0,0 +1,134 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "FadeButton.h"
+#include "TestSingletons.h"
+
+#define BUTTON_SIZE 80
+#define SWEEP_FRAMES 64
+
+////////////////////////////////////////////////////////////////////////////////
+
+// lets the benchmark step the hover animation directly
+class HoverButton : public FadeButton
+{
+public:
+  HoverButton(QWidget *parent)
+    : FadeButton(parent)
+  {
+  }
+
+  void SetHoverPercent(float percent) { SetHover(percent); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// one hover sweep of a button, painting from the shared background layers versus
+// rasterizing the rounded background on every paint as before
+class BenchFadeButtonPaint : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void cachedMatchesUncached();
+  void cachedHoverSweep();
+  void uncachedHoverSweep();
+
+private:
+  HoverButton *m_Button;
+  QPixmap m_Target;
+
+  void Paint(float hover, bool cached);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchFadeButtonPaint::initTestCase()
+{
+  TestSingletons::Instantiate();
+
+  m_Button = new HoverButton(0);
+  m_Button->setText(QStringLiteral("Go"));
+  m_Button->SetLabel(QStringLiteral("1/1"));
+  m_Button->resize(BUTTON_SIZE, BUTTON_SIZE);
+  m_Target = QPixmap(BUTTON_SIZE, BUTTON_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchFadeButtonPaint::cleanupTestCase()
+{
+  delete m_Button;
+  m_Button = 0;
+  TestSingletons::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchFadeButtonPaint::Paint(float hover, bool cached)
+{
+  if (!cached)
+    QPixmapCache::clear();
+
+  m_Button->SetHoverPercent(hover);
+  m_Target.fill(Qt::transparent);
+  m_Button->render(&m_Target);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchFadeButtonPaint::cachedMatchesUncached()
+{
+  Paint(0.5f, /*cached*/ false);
+  QImage uncached(m_Target.toImage());
+  Paint(0.5f, /*cached*/ true);
+  QCOMPARE(m_Target.toImage(), uncached);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchFadeButtonPaint::cachedHoverSweep()
+{
+  QBENCHMARK
+  {
+    for (int i = 0; i <= SWEEP_FRAMES; i++)
+      Paint(i / static_cast<float>(SWEEP_FRAMES), /*cached*/ true);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchFadeButtonPaint::uncachedHoverSweep()
+{
+  QBENCHMARK
+  {
+    for (int i = 0; i <= SWEEP_FRAMES; i++)
+      Paint(i / static_cast<float>(SWEEP_FRAMES), /*cached*/ false);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_MAIN(BenchFadeButtonPaint)
+#include "BenchFadeButtonPaint.moc"
@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "OSCParser.h"
+#include "Utils.h"
+
+#define SEND_PATH "/eos/user/1/wheel/pan"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// cost of one outbound float message from a prebuilt template, versus encoding the address
+// and arguments from scratch the way every send used to; all on one thread, so packets/sec
+// per core is the inverse of the reported time per iteration
+class BenchPacketTemplate : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void matchesWriter();
+  void templateCreate();
+  void writerCreate();
+
+private:
+  OSCAddressTable::ID m_PathId;
+  OSCPacketTemplate m_Template;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchPacketTemplate::initTestCase()
+{
+  OSCAddressTable::Instantiate();
+  m_PathId = OAT.Intern(SEND_PATH);
+  QVERIFY(m_PathId != OSCAddressTable::INVALID_ID);
+  m_Template.Build(m_PathId, 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchPacketTemplate::cleanupTestCase()
+{
+  OAT.Release(m_PathId);
+  OSCAddressTable::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchPacketTemplate::matchesWriter()
+{
+  float values[2] = {0.25f, -1.5f};
+
+  size_t size = 0;
+  char *packet = m_Template.Create(values, 2, size);
+  QVERIFY(packet != 0);
+
+  OSCPacketWriter packetWriter(SEND_PATH);
+  packetWriter.AddFloat32(values[0]);
+  packetWriter.AddFloat32(values[1]);
+  size_t expectedSize = 0;
+  char *expected = packetWriter.Create(expectedSize);
+  QVERIFY(expected != 0);
+
+  QCOMPARE(size, expectedSize);
+  QVERIFY(memcmp(packet, expected, size) == 0);
+
+  delete[] packet;
+  delete[] expected;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchPacketTemplate::templateCreate()
+{
+  float values[2] = {0, 0};
+  QBENCHMARK
+  {
+    values[0] += 0.001f;
+    size_t size = 0;
+    char *packet = m_Template.Create(values, 2, size);
+    delete[] packet;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchPacketTemplate::writerCreate()
+{
+  QString path(SEND_PATH);
+  float values[2] = {0, 0};
+  QBENCHMARK
+  {
+    values[0] += 0.001f;
+    QString oscPath(path);
+    Utils::MakeLocalOSCPath(false, oscPath);
+    OSCPacketWriter packetWriter(oscPath.toUtf8().constData());
+    packetWriter.AddFloat32(values[0]);
+    packetWriter.AddFloat32(values[1]);
+    size_t size = 0;
+    char *packet = packetWriter.Create(size);
+    delete[] packet;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_MAIN(BenchPacketTemplate)
+#include "BenchPacketTemplate.moc"
@@ -0,0 +1,125 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "OSCParser.h"
+#include "Toys.h"
+#include "TestSingletons.h"
+#include "TestToyClient.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// throughput of a drained receive queue of label updates, dispatched as one batch
+// versus one Recv call per packet the way ProcessRecvQ used to
+class BenchRecvBatch : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void batch();
+  void perPacket();
+
+private:
+  enum EnumConstants
+  {
+    QUEUE_SIZE = 1000
+  };
+
+  TestToyClient m_Client;
+  Toys *m_Toys;
+  PACKET_Q m_Q;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchRecvBatch::initTestCase()
+{
+  TestSingletons::Instantiate();
+
+  m_Toys = new Toys(&m_Client, 0);
+  Toy *toy = m_Toys->AddToy(Toy::TOY_LABEL_GRID);
+  QVERIFY(toy != 0);
+
+  Toy::RECV_WIDGETS recvWidgets;
+  toy->AddRecvWidgets(recvWidgets);
+  QVERIFY(!recvWidgets.empty());
+
+  QList<QByteArray> paths;
+  for (Toy::RECV_WIDGETS::const_iterator i = recvWidgets.begin(); i != recvWidgets.end(); i++)
+    paths.append(OAT.Get(i->first).utf8);
+
+  // an Eos style flood, where each label is updated many times per drained queue
+  for (int i = 0; i < QUEUE_SIZE; i++)
+  {
+    OSCPacketWriter packetWriter(paths[i % paths.size()].constData());
+    packetWriter.AddString(QByteArray::number(i).constData());
+
+    sPacket packet;
+    packet.data = packetWriter.Create(packet.size);
+    QVERIFY(packet.data != 0);
+    m_Q.push_back(packet);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchRecvBatch::cleanupTestCase()
+{
+  for (PACKET_Q::const_iterator i = m_Q.begin(); i != m_Q.end(); i++)
+    delete[] i->data;
+  m_Q.clear();
+
+  // toys are deleted later, and must be gone before the address table is
+  m_Toys->Clear();
+  delete m_Toys;
+  m_Toys = 0;
+  QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+  TestSingletons::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchRecvBatch::batch()
+{
+  QBENCHMARK
+  {
+    m_Toys->Recv(m_Q);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchRecvBatch::perPacket()
+{
+  QBENCHMARK
+  {
+    for (PACKET_Q::const_iterator i = m_Q.begin(); i != m_Q.end(); i++)
+      m_Toys->Recv(i->data, i->size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_MAIN(BenchRecvBatch)
+#include "BenchRecvBatch.moc"
@@ -0,0 +1,145 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "OSCParser.h"
+#include "ToySlider.h"
+#include "TestSingletons.h"
+
+#define FEEDBACK_PATH "/eos/fader/1/1"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// per-message cost of slider feedback, with the min/max range parsed once by the setters
+// versus the per-message parsing it replaced
+class BenchSliderFeedback : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void cachedRange();
+  void parsedRange();
+
+private:
+  struct sMessage
+  {
+    char *packet;
+    size_t size;
+    OSCArgument *args;
+    size_t argCount;
+  };
+
+  sMessage m_Messages[2];
+
+  void InitMessage(float value, sMessage &msg);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchSliderFeedback::InitMessage(float value, sMessage &msg)
+{
+  OSCPacketWriter packetWriter(FEEDBACK_PATH);
+  packetWriter.AddFloat32(value);
+  msg.packet = packetWriter.Create(msg.size);
+  msg.argCount = 0xffffffff;
+  msg.args = (msg.packet ? OSCArgument::GetArgs(msg.packet, msg.size, msg.argCount) : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchSliderFeedback::initTestCase()
+{
+  TestSingletons::Instantiate();
+
+  // alternate between two values, so every message moves the slider
+  InitMessage(25.0f, m_Messages[0]);
+  InitMessage(75.0f, m_Messages[1]);
+  for (size_t i = 0; i < 2; i++)
+  {
+    QVERIFY(m_Messages[i].args != 0);
+    QCOMPARE(m_Messages[i].argCount, static_cast<size_t>(1));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchSliderFeedback::cleanupTestCase()
+{
+  for (size_t i = 0; i < 2; i++)
+  {
+    delete[] m_Messages[i].args;
+    delete[] m_Messages[i].packet;
+  }
+
+  TestSingletons::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchSliderFeedback::cachedRange()
+{
+  ToySliderWidget slider(0);
+  slider.SetFeedbackPath(FEEDBACK_PATH);
+  slider.SetMin("0");
+  slider.SetMax("100");
+  QString path(slider.GetFeedbackPath());
+
+  slider.Recv(path, m_Messages[0].args, m_Messages[0].argCount);
+  QVERIFY(qAbs(slider.GetPercent() - 0.25f) < 0.0001f);
+
+  unsigned int n = 0;
+  QBENCHMARK
+  {
+    const sMessage &msg = m_Messages[++n & 1];
+    slider.Recv(path, msg.args, msg.argCount);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchSliderFeedback::parsedRange()
+{
+  // only the range parsing each message used to repeat, without the slider update
+  QString minStr("0");
+  QString maxStr("100");
+
+  float percent = 0;
+  unsigned int n = 0;
+  QBENCHMARK
+  {
+    const sMessage &msg = m_Messages[++n & 1];
+    float value = 0;
+    msg.args[0].GetFloat(value);
+    float minValue = (OSCArgument::IsFloatString(minStr.toUtf8().constData()) ? minStr.toFloat() : 0);
+    float maxValue = (OSCArgument::IsFloatString(maxStr.toUtf8().constData()) ? maxStr.toFloat() : 0);
+    float range = (maxValue - minValue);
+    percent = ((range == 0) ? 0 : (value - minValue) / range);
+  }
+
+  QVERIFY(percent >= 0 && percent <= 1.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_MAIN(BenchSliderFeedback)
+#include "BenchSliderFeedback.moc"
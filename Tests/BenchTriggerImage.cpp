@@ -0,0 +1,233 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "OSCParser.h"
+#include "ToyLabel.h"
+#include "ToyMath.h"
+#include "TestSingletons.h"
+#include "TestToyClient.h"
+
+#define TRIGGER_PATH "/label/1/image"
+#define IMAGE_COUNT 6
+#define IMAGE_WIDTH 1600
+#define IMAGE_HEIGHT 1200
+#define WAIT_MS 30000
+
+////////////////////////////////////////////////////////////////////////////////
+
+// time from a label trigger message until its image can be drawn at the label's size,
+// for images nobody has loaded yet versus images prefetched the way Toys::Load does
+class BenchTriggerImage : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void coldTrigger();
+  void warmTrigger();
+
+private:
+  QTemporaryDir m_Dir;
+  QStringList m_ColdPaths;
+  QStringList m_WarmPaths;
+  TestToyClient m_Client;
+  ToyLabelWidget *m_Label;
+
+  void WriteImage(const QString &path, int seed);
+  qint64 Trigger(const QString &path);
+  bool IsScaled(const QString &path) const;
+  bool WaitForPrefetch();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchTriggerImage::WriteImage(const QString &path, int seed)
+{
+  // noisy enough that decoding costs about what a photo does
+  QImage image(IMAGE_WIDTH, IMAGE_HEIGHT, QImage::Format_RGB32);
+  FastRandom random(static_cast<uint32_t>(seed));
+  for (int y = 0; y < IMAGE_HEIGHT; y++)
+  {
+    QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+    for (int x = 0; x < IMAGE_WIDTH; x++)
+      line[x] = (random.Next() | 0xff000000);
+  }
+
+  QVERIFY(image.save(path, "PNG"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchTriggerImage::initTestCase()
+{
+  TestSingletons::Instantiate();
+  QVERIFY(m_Dir.isValid());
+
+  for (int i = 0; i < IMAGE_COUNT * 2; i++)
+  {
+    QString path(m_Dir.filePath(QString("image%1.png").arg(i)));
+    WriteImage(path, i);
+    if (i < IMAGE_COUNT)
+      m_ColdPaths << path;
+    else
+      m_WarmPaths << path;
+  }
+
+  m_Label = new ToyLabelWidget(&m_Client, 0);
+  m_Label->SetTriggerPath(TRIGGER_PATH);
+  m_Label->resize(160, 90);
+  m_Label->show();
+  QCoreApplication::processEvents();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchTriggerImage::cleanupTestCase()
+{
+  delete m_Label;
+  m_Label = 0;
+  TestSingletons::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool BenchTriggerImage::IsScaled(const QString &path) const
+{
+  const PixmapCache::SCALED_LIST &scaled = PMC.GetScaledList();
+  for (PixmapCache::SCALED_LIST::const_iterator i = scaled.begin(); i != scaled.end(); i++)
+  {
+    if (i->second.path == path && !i->second.pending)
+      return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool BenchTriggerImage::WaitForPrefetch()
+{
+  QElapsedTimer timer;
+  timer.start();
+  while (timer.elapsed() < WAIT_MS)
+  {
+    QCoreApplication::processEvents();
+
+    bool pending = false;
+    for (PixmapCache::PIXMAP_LIST::const_iterator i = PMC.GetList().begin(); !pending && i != PMC.GetList().end(); i++)
+      pending = i->second.pending;
+    for (PixmapCache::SCALED_LIST::const_iterator i = PMC.GetScaledList().begin(); !pending && i != PMC.GetScaledList().end(); i++)
+      pending = i->second.pending;
+
+    if (!pending)
+      return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 BenchTriggerImage::Trigger(const QString &path)
+{
+  OSCPacketWriter packetWriter(TRIGGER_PATH);
+  packetWriter.AddString(path.toUtf8().constData());
+  size_t size = 0;
+  char *packet = packetWriter.Create(size);
+  size_t argCount = 0xffffffff;
+  OSCArgument *args = (packet ? OSCArgument::GetArgs(packet, size, argCount) : 0);
+  if (!args)
+  {
+    delete[] packet;
+    return -1;
+  }
+
+  QString triggerPath(m_Label->GetTriggerPath());
+  QElapsedTimer timer;
+  timer.start();
+
+  m_Label->Recv(triggerPath, args, argCount);
+  while (!IsScaled(path) && timer.elapsed() < WAIT_MS)
+    QCoreApplication::processEvents();
+
+  qint64 elapsedNS = (IsScaled(path) ? timer.nsecsElapsed() : -1);
+
+  delete[] args;
+  delete[] packet;
+  return elapsedNS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchTriggerImage::coldTrigger()
+{
+  PMC.Clear();
+
+  qint64 totalNS = 0;
+  for (int i = 0; i < m_ColdPaths.size(); i++)
+  {
+    qint64 elapsedNS = Trigger(m_ColdPaths[i]);
+    QVERIFY(elapsedNS >= 0);
+    totalNS += elapsedNS;
+  }
+
+  QTest::setBenchmarkResult(totalNS / (m_ColdPaths.size() * 1000000.0), QTest::WalltimeMilliseconds);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchTriggerImage::warmTrigger()
+{
+  PMC.Clear();
+
+  QWidget *w = m_Label->GetWidget();
+  PixmapCache::sPrefetchSize prefetchSize;
+  prefetchSize.size = w->size();
+  prefetchSize.dpr = w->devicePixelRatioF();
+  PMC.SetPrefetchSizes(PixmapCache::PREFETCH_SIZES(1, prefetchSize));
+
+  for (int i = 0; i < m_WarmPaths.size(); i++)
+    PMC.Prefetch(m_WarmPaths[i]);
+  QVERIFY(WaitForPrefetch());
+
+  // a warm trigger decodes and scales nothing
+  PixmapCache::sStats before(PMC.GetStats());
+
+  qint64 totalNS = 0;
+  for (int i = 0; i < m_WarmPaths.size(); i++)
+  {
+    qint64 elapsedNS = Trigger(m_WarmPaths[i]);
+    QVERIFY(elapsedNS >= 0);
+    totalNS += elapsedNS;
+  }
+
+  QCOMPARE(PMC.GetStats().decodes, before.decodes);
+  QCOMPARE(PMC.GetStats().scales, before.scales);
+
+  QTest::setBenchmarkResult(totalNS / (m_WarmPaths.size() * 1000000.0), QTest::WalltimeMilliseconds);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_MAIN(BenchTriggerImage)
+#include "BenchTriggerImage.moc"
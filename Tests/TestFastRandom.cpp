@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "ToyMath.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// saved layouts store a flicker seed and expect the same flicker back, so the
+// sequence for a seed must never change
+class TestFastRandom : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void knownSequence_data();
+  void knownSequence();
+  void reseedRestarts();
+  void nearbySeedsDiffer();
+  void floatBounds();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFastRandom::knownSequence_data()
+{
+  QTest::addColumn<quint32>("seed");
+  QTest::addColumn<QList<quint32> >("expected");
+
+  QTest::newRow("0") << 0u << (QList<quint32>() << 0xe308dc58u << 0x4392d0e4u << 0x03318f97u << 0xac593a63u << 0x08535f0au << 0x83532d1fu << 0x063f9b44u << 0x5e9c32a6u);
+  QTest::newRow("1") << 1u << (QList<quint32>() << 0x9190299eu << 0xc1017b27u << 0xe3af522fu << 0x7d71fb05u << 0x787816c2u << 0xfbbe0c00u << 0x5a5c175au << 0x89063de1u);
+  QTest::newRow("12345") << 12345u << (QList<quint32>() << 0x1eea3cc1u << 0x1a40a62eu << 0xfc4cd240u << 0xdffc5b56u << 0xeac8a83du << 0x4f8da78fu << 0xe234001bu << 0x7cbb1e72u);
+  QTest::newRow("max") << 0xffffffffu << (QList<quint32>() << 0x31d28326u << 0x728481f8u << 0x8c70d5d1u << 0x7066baf4u << 0x3a707f2cu << 0x3ed16aa6u << 0xdb308f61u << 0x92e32daau);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFastRandom::knownSequence()
+{
+  QFETCH(quint32, seed);
+  QFETCH(QList<quint32>, expected);
+
+  FastRandom random(seed);
+  for (int i = 0; i < expected.size(); i++)
+    QCOMPARE(static_cast<quint32>(random.Next()), expected[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFastRandom::reseedRestarts()
+{
+  FastRandom a(42);
+  uint32_t first[16];
+  for (int i = 0; i < 16; i++)
+    first[i] = a.Next();
+
+  a.Seed(42);
+  for (int i = 0; i < 16; i++)
+    QCOMPARE(a.Next(), first[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFastRandom::nearbySeedsDiffer()
+{
+  // a grid seeds its widgets with consecutive seeds
+  for (uint32_t seed = 0; seed < 64; seed++)
+  {
+    FastRandom a(seed);
+    FastRandom b(seed + 1);
+    int same = 0;
+    for (int i = 0; i < 32; i++)
+    {
+      if (a.Next() == b.Next())
+        same++;
+    }
+    QCOMPARE(same, 0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFastRandom::floatBounds()
+{
+  FastRandom random(7);
+  float minValue = 1.0f;
+  float maxValue = 0;
+  double sum = 0;
+  const int count = 1000000;
+  for (int i = 0; i < count; i++)
+  {
+    float f = random.NextFloat();
+    QVERIFY(f >= 0 && f < 1.0f);
+    minValue = qMin(minValue, f);
+    maxValue = qMax(maxValue, f);
+    sum += f;
+  }
+
+  QVERIFY(minValue < 0.0001f);
+  QVERIFY(maxValue > 0.9999f);
+  QVERIFY(qAbs(sum / count - 0.5) < 0.01);
+
+  // the largest value Next can produce still maps below 1
+  QVERIFY((0xffffffffu >> 8) * (1.0f / 16777216.0f) < 1.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_APPLESS_MAIN(TestFastRandom)
+#include "TestFastRandom.moc"
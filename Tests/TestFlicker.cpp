@@ -0,0 +1,274 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "GeneratorThread.h"
+
+#define FLICKER_PATH "/flicker/1"
+#define FLICKER_MIN 10.0f
+#define FLICKER_MAX 20.0f
+
+////////////////////////////////////////////////////////////////////////////////
+
+// drives one flicker generator through the same calls the GUI and generator thread
+// make, on a simulated clock, and decodes every packet it sends
+class FlickerHarness : public GeneratorThread, public GeneratorThread::GeneratorClient
+{
+public:
+  struct sPacket
+  {
+    float value;
+    qint64 nowNS;
+  };
+
+  typedef std::vector<sPacket> PACKETS;
+
+  FlickerHarness()
+    : m_Id(INVALID_ID)
+    , m_NowNS(0)
+    , m_BadPackets(0)
+  {
+    SetClient(this);
+  }
+
+  void Reset(float bpm, float minTimeScale, float maxTimeScale, quint32 seed)
+  {
+    if (m_Id != INVALID_ID)
+      Remove(m_Id);
+
+    m_Id = Add(GENERATOR_FLICKER, 1);
+    SetBPM(m_Id, bpm);
+    SetTimeScaleRange(m_Id, minTimeScale, maxTimeScale);
+
+    sOutput output;
+    output.enabled = true;
+    output.floatCount = 1;
+    output.min = FLICKER_MIN;
+    output.max = FLICKER_MAX;
+    output.packetTemplate.Build(OAT.Intern(FLICKER_PATH), 1);
+    SetOutput(m_Id, output);
+    OAT.Release(OAT.Intern(FLICKER_PATH));
+
+    SetPaused(m_Id, false);
+    SetSeed(m_Id, seed);
+    m_NowNS = 0;
+    m_Packets.clear();
+    m_BadPackets = 0;
+  }
+
+  void Reseed(quint32 seed)
+  {
+    SetSeed(m_Id, seed);
+    m_Packets.clear();
+  }
+
+  void Advance(qint64 ns)
+  {
+    m_NowNS += ns;
+    Update(m_Generators[m_Id], m_NowNS, static_cast<unsigned int>(ns / 1000000));
+  }
+
+  qint64 GetNowNS() const { return m_NowNS; }
+  const PACKETS &GetPackets() const { return m_Packets; }
+  int GetBadPackets() const { return m_BadPackets; }
+
+  virtual void GeneratorClient_Send(bool local, char *data, size_t size)
+  {
+    // one float argument after the padded address and type tags
+    QByteArray expected(FLICKER_PATH);
+    OSCPacketTemplate::AppendPadding(expected);
+    expected.append(",f");
+    OSCPacketTemplate::AppendPadding(expected);
+
+    if (local || size != static_cast<size_t>(expected.size() + 4) || memcmp(data, expected.constData(), expected.size()) != 0)
+      m_BadPackets++;
+    else
+    {
+      quint32 bits = qFromBigEndian<quint32>(data + expected.size());
+      sPacket packet;
+      memcpy(&packet.value, &bits, 4);
+      packet.nowNS = m_NowNS;
+      m_Packets.push_back(packet);
+    }
+
+    delete[] data;
+  }
+
+protected:
+  ID m_Id;
+  qint64 m_NowNS;
+  PACKETS m_Packets;
+  int m_BadPackets;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// saved layouts store a flicker seed, so a seed must always give the same values at
+// the same times, all the way out to the packets sent
+class TestFlicker : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void fixedRate();
+  void randomRate();
+  void stepSizeDoesNotMatter();
+  void reseedRepeats();
+
+private:
+  static float Map(float value);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFlicker::initTestCase()
+{
+  OSCAddressTable::Instantiate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFlicker::cleanupTestCase()
+{
+  OSCAddressTable::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+float TestFlicker::Map(float value)
+{
+  return (FLICKER_MIN + (FLICKER_MAX - FLICKER_MIN) * value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFlicker::fixedRate()
+{
+  // 600 bpm is one value every 100 ms, each the next float from the seed
+  FlickerHarness flicker;
+  flicker.Reset(600, 0, 0, 1234);
+  for (int i = 0; i < 10000; i++)
+    flicker.Advance(1000000LL);
+
+  const FlickerHarness::PACKETS &packets = flicker.GetPackets();
+  QCOMPARE(flicker.GetBadPackets(), 0);
+  QCOMPARE(static_cast<int>(packets.size()), 100);
+
+  FastRandom random(1234);
+  for (size_t i = 0; i < packets.size(); i++)
+  {
+    QCOMPARE(packets[i].value, Map(random.NextFloat()));
+    QCOMPARE(packets[i].nowNS, static_cast<qint64>(i + 1) * 100000000LL);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFlicker::randomRate()
+{
+  // with a time scale range each beat length is drawn from the same stream, first at
+  // seeding and then after every value
+  const float minTimeScale = 0.5f;
+  const float maxTimeScale = 2.0f;
+  FlickerHarness flicker;
+  flicker.Reset(120, minTimeScale, maxTimeScale, 99);
+  for (int i = 0; i < 60000; i++)
+    flicker.Advance(1000000LL);
+
+  const FlickerHarness::PACKETS &packets = flicker.GetPackets();
+  QCOMPARE(flicker.GetBadPackets(), 0);
+  QVERIFY(packets.size() > 10);
+
+  FastRandom random(99);
+  qint64 dueNS = 0;
+  for (size_t i = 0; i < packets.size(); i++)
+  {
+    float t = random.NextFloat();
+    dueNS += (static_cast<qint64>(GeneratorThread::GetMsPerBeat(120, minTimeScale * t + maxTimeScale * (1.0f - t))) * 1000000);
+    QCOMPARE(packets[i].value, Map(random.NextFloat()));
+    QCOMPARE(packets[i].nowNS, dueNS);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFlicker::stepSizeDoesNotMatter()
+{
+  // coarse, uneven updates send the same values, only later and several at once
+  FlickerHarness fine;
+  fine.Reset(600, 0.5f, 2.0f, 7);
+  for (int i = 0; i < 20000; i++)
+    fine.Advance(1000000LL);
+
+  FlickerHarness coarse;
+  coarse.Reset(600, 0.5f, 2.0f, 7);
+  for (unsigned int n = 0; coarse.GetNowNS() < fine.GetNowNS(); n++)
+    coarse.Advance(qMin((1 + (n * 7919) % 250) * 1000000LL, fine.GetNowNS() - coarse.GetNowNS()));
+
+  const FlickerHarness::PACKETS &a = fine.GetPackets();
+  const FlickerHarness::PACKETS &b = coarse.GetPackets();
+  QCOMPARE(b.size(), a.size());
+  for (size_t i = 0; i < a.size(); i++)
+  {
+    QCOMPARE(b[i].value, a[i].value);
+    QVERIFY(b[i].nowNS >= a[i].nowNS);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestFlicker::reseedRepeats()
+{
+  FlickerHarness flicker;
+  flicker.Reset(300, 0.5f, 2.0f, 5);
+  for (int i = 0; i < 30000; i++)
+    flicker.Advance(1000000LL);
+  FlickerHarness::PACKETS first(flicker.GetPackets());
+  QVERIFY(!first.empty());
+
+  // part way through a beat, so the leftover time must not carry over either
+  flicker.Advance(37000000LL);
+  qint64 reseedNS = flicker.GetNowNS();
+  flicker.Reseed(5);
+  for (int i = 0; i < 30000; i++)
+    flicker.Advance(1000000LL);
+
+  const FlickerHarness::PACKETS &second = flicker.GetPackets();
+  QCOMPARE(second.size(), first.size());
+  for (size_t i = 0; i < first.size(); i++)
+  {
+    QCOMPARE(second[i].value, first[i].value);
+    QCOMPARE(second[i].nowNS - reseedNS, first[i].nowNS);
+  }
+
+  // another seed is another sequence
+  flicker.Reseed(6);
+  for (int i = 0; i < 30000; i++)
+    flicker.Advance(1000000LL);
+  QVERIFY(flicker.GetPackets()[0].value != first[0].value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_APPLESS_MAIN(TestFlicker)
+#include "TestFlicker.moc"
@@ -0,0 +1,214 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "GeneratorThread.h"
+
+#define BPM 120.0f
+#define SEGMENT_NS 250000000LL  // a quarter turn, half a beat at 120 bpm
+#define HOUR_NS 3600000000000LL
+
+////////////////////////////////////////////////////////////////////////////////
+
+// drives one metro generator through GeneratorThread::Update on a simulated clock,
+// recording the ticks it sends instead of building packets
+class MetroHarness : public GeneratorThread
+{
+public:
+  struct sTick
+  {
+    EnumMetroTick tick;
+    qint64 atNS;
+    qint64 nowNS;
+  };
+
+  typedef std::vector<sTick> TICKS;
+
+  MetroHarness()
+    : m_NowNS(0)
+  {
+  }
+
+  void Reset(float bpm, qint64 lookaheadNS)
+  {
+    m_Generator = sGenerator();
+    m_Generator.type = GENERATOR_METRO;
+    m_Generator.bpm = bpm;
+    m_Generator.lookaheadNS = lookaheadNS;
+    UpdateSpeed(m_Generator);
+    SetAnchor(m_Generator, 0, 0);
+    m_NowNS = 0;
+    m_Ticks.clear();
+  }
+
+  void Advance(qint64 ns)
+  {
+    m_NowNS += ns;
+    Update(m_Generator, m_NowNS, static_cast<unsigned int>(ns / 1000000));
+  }
+
+  qint64 GetNowNS() const { return m_NowNS; }
+  const TICKS &GetTicks() const { return m_Ticks; }
+
+protected:
+  sGenerator m_Generator;
+  qint64 m_NowNS;
+  TICKS m_Ticks;
+
+  virtual void SendTick(const sOutput & /*output*/, EnumMetroTick tick, qint64 atNS)
+  {
+    sTick t;
+    t.tick = tick;
+    t.atNS = atNS;
+    t.nowNS = m_NowNS;
+    m_Ticks.push_back(t);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+class TestMetroPhase : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void phaseTimeRoundTrip();
+  void noDriftWithLookahead();
+  void lateTicksWithoutLookahead();
+  void stallSendsEveryTick();
+
+private:
+  static qint64 GetJitteredStepNS(unsigned int n);
+  static void VerifyTickOrder(const MetroHarness::TICKS &ticks);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 TestMetroPhase::GetJitteredStepNS(unsigned int n)
+{
+  // 1 to 40 ms, in an order that never lines up with the segment length
+  return ((1 + ((n * 7919) % 40)) * 1000000LL + (n % 13) * 1013);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestMetroPhase::VerifyTickOrder(const MetroHarness::TICKS &ticks)
+{
+  // the first tick sent is for segment 1, the anchor itself is segment 0
+  for (size_t i = 0; i < ticks.size(); i++)
+  {
+    int segment = static_cast<int>((i + 1) % GeneratorThread::METRO_SEGMENT_COUNT);
+    QCOMPARE(ticks[i].tick, GeneratorThread::GetMetroTickForSegment(segment));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestMetroPhase::phaseTimeRoundTrip()
+{
+  double speed = ((BPM / 60000000000.0) * M_PI);
+  for (qint64 t = 0; t < HOUR_NS; t += 999999937LL)
+  {
+    double phase = GeneratorThread::GetPhase(0, speed, t);
+    qint64 atNS = GeneratorThread::GetPhaseTimeNS(0, 0, speed, phase);
+    QVERIFY2(qAbs(atNS - t) <= 1, qPrintable(QString("%1 ns became %2 ns").arg(t).arg(atNS)));
+  }
+
+  QCOMPARE(GeneratorThread::GetPhaseTimeNS(123, 1.0, 0, 2.0), static_cast<qint64>(123));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestMetroPhase::noDriftWithLookahead()
+{
+  // with more lookahead than the longest step, every tick is stamped exactly when its
+  // segment starts, however long the generator runs
+  MetroHarness metro;
+  metro.Reset(BPM, 50000000LL);
+
+  for (unsigned int n = 0; metro.GetNowNS() < HOUR_NS; n++)
+    metro.Advance(GetJitteredStepNS(n));
+
+  const MetroHarness::TICKS &ticks = metro.GetTicks();
+  QVERIFY(ticks.size() >= static_cast<size_t>(HOUR_NS / SEGMENT_NS));
+  VerifyTickOrder(ticks);
+
+  for (size_t i = 0; i < ticks.size(); i++)
+  {
+    qint64 expectedNS = (static_cast<qint64>(i + 1) * SEGMENT_NS);
+    QVERIFY2(qAbs(ticks[i].atNS - expectedNS) <= 1, qPrintable(QString("tick %1 at %2 ns, expected %3 ns").arg(i).arg(ticks[i].atNS).arg(expectedNS)));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestMetroPhase::lateTicksWithoutLookahead()
+{
+  // without lookahead a tick goes out on the first update after its segment starts,
+  // never more than one step late, and the error does not grow over time
+  MetroHarness metro;
+  metro.Reset(BPM, 0);
+
+  qint64 maxStepNS = 0;
+  for (unsigned int n = 0; metro.GetNowNS() < HOUR_NS; n++)
+  {
+    qint64 stepNS = GetJitteredStepNS(n);
+    maxStepNS = qMax(maxStepNS, stepNS);
+    metro.Advance(stepNS);
+  }
+
+  const MetroHarness::TICKS &ticks = metro.GetTicks();
+  QCOMPARE(static_cast<qint64>(ticks.size()), metro.GetNowNS() / SEGMENT_NS);
+  VerifyTickOrder(ticks);
+
+  for (size_t i = 0; i < ticks.size(); i++)
+  {
+    qint64 lateNS = (ticks[i].atNS - static_cast<qint64>(i + 1) * SEGMENT_NS);
+    QVERIFY(lateNS >= -1);
+    QVERIFY(lateNS <= maxStepNS);
+    QCOMPARE(ticks[i].atNS, qMax(ticks[i].nowNS, static_cast<qint64>(i + 1) * SEGMENT_NS));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestMetroPhase::stallSendsEveryTick()
+{
+  MetroHarness metro;
+  metro.Reset(BPM, 0);
+
+  metro.Advance(100000000LL);
+  QVERIFY(metro.GetTicks().empty());
+
+  // a ten second stall, then everything missed arrives on the next update
+  metro.Advance(10000000000LL);
+  const MetroHarness::TICKS &ticks = metro.GetTicks();
+  QCOMPARE(static_cast<qint64>(ticks.size()), metro.GetNowNS() / SEGMENT_NS);
+  VerifyTickOrder(ticks);
+
+  for (size_t i = 0; i < ticks.size(); i++)
+    QCOMPARE(ticks[i].nowNS, metro.GetNowNS());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_APPLESS_MAIN(TestMetroPhase)
+#include "TestMetroPhase.moc"
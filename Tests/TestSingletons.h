@@ -0,0 +1,58 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef TEST_SINGLETONS_H
+#define TEST_SINGLETONS_H
+
+#include "Utils.h"
+#include "FrameScheduler.h"
+#include "GeneratorThread.h"
+#include "Wavetable.h"
+#include "EosTimer.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// the process-wide tables main() sets up, for tests that build widgets or toys
+class TestSingletons
+{
+public:
+  static void Instantiate()
+  {
+    EosTimer::Init();
+    PixmapCache::Instantiate();
+    OSCAddressTable::Instantiate();
+    FrameScheduler::Instantiate();
+    Wavetable::Init();
+    GeneratorThread::Instantiate();
+  }
+
+  static void Shutdown()
+  {
+    GeneratorThread::Shutdown();
+    FrameScheduler::Shutdown();
+    OSCAddressTable::Shutdown();
+    PixmapCache::Shutdown();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
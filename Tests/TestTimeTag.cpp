@@ -0,0 +1,398 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "GeneratorThread.h"
+
+#define NTP_UNIX_OFFSET 2208988800ULL  // seconds from 1900 to 1970
+#define SIMULATED_UNIX_NS 1767225600000000000LL  // 2026-01-01T00:00:00Z
+#define SEGMENT_NS 250000000LL  // a quarter turn, half a beat at 120 bpm
+
+////////////////////////////////////////////////////////////////////////////////
+
+// captures what GeneratorThread::SendPacket hands to its client
+class BundleHarness : public GeneratorThread, private GeneratorThread::GeneratorClient
+{
+public:
+  struct sSent
+  {
+    bool local;
+    QByteArray data;
+  };
+
+  typedef std::vector<sSent> SENT;
+
+  BundleHarness()
+  {
+    SetClient(this);
+  }
+
+  void Send(bool local, const QByteArray &msg, qint64 atNS)
+  {
+    sOutput output;
+    output.enabled = true;
+    output.local = local;
+
+    char *data = new char[msg.size()];
+    memcpy(data, msg.constData(), msg.size());
+    SendPacket(output, data, static_cast<size_t>(msg.size()), atNS);
+  }
+
+  qint64 GetNowNS() const { return m_Clock.nsecsElapsed(); }
+  qint64 GetUnixOffsetNS() const { return m_UnixOffsetNS; }
+  const SENT &GetSent() const { return m_Sent; }
+
+private:
+  SENT m_Sent;
+
+  virtual void GeneratorClient_Send(bool local, char *data, size_t size)
+  {
+    sSent sent;
+    sent.local = local;
+    sent.data = QByteArray(data, static_cast<int>(size));
+    m_Sent.push_back(sent);
+    delete[] data;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// runs generators through GeneratorThread::Process on a simulated clock, and plays
+// what they send the way a receiver honouring time tags would
+class ReceiverHarness : public GeneratorThread, private GeneratorThread::GeneratorClient
+{
+public:
+  struct sPlayed
+  {
+    qint64 sentNS;
+    qint64 playedNS;
+    bool bundled;
+    float value;
+  };
+
+  typedef std::vector<sPlayed> PLAYED;
+
+  ReceiverHarness()
+    : m_NowNS(0)
+  {
+    m_UnixOffsetNS = SIMULATED_UNIX_NS;
+    SetClient(this);
+  }
+
+  ID AddGenerator(EnumGeneratorType type, unsigned int intervalMS, float bpm, unsigned int lookaheadMS, const OSCPacketTemplate &packetTemplate)
+  {
+    ID id = Add(type, intervalMS);
+    SetBPM(id, bpm);
+    SetLookahead(id, lookaheadMS);
+
+    sOutput output;
+    output.enabled = true;
+    output.floatCount = 1;
+    output.min = 0;
+    output.max = 1;
+    output.packetTemplate = packetTemplate;
+    for (int i = 0; i < METRO_TICK_COUNT; i++)
+      output.tickPackets[i] = GetMessage(static_cast<float>(i));
+    SetOutput(id, output);
+
+    SetPaused(id, false);
+    return id;
+  }
+
+  void Advance(qint64 ns)
+  {
+    m_NowNS += ns;
+    qint64 nextNS = 0;
+    Process(m_NowNS, nextNS);
+  }
+
+  qint64 GetNowNS() const { return m_NowNS; }
+  const PLAYED &GetPlayed() const { return m_Played; }
+
+  static QByteArray GetMessage(float value);
+
+  static qint64 GetUnixNS(quint64 timeTag)
+  {
+    // rounding the fraction up undoes the truncation in GetTimeTag exactly
+    qint64 seconds = static_cast<qint64>((timeTag >> 32) - NTP_UNIX_OFFSET);
+    qint64 fractionNS = static_cast<qint64>(((timeTag & 0xffffffffULL) * 1000000000ULL + 0xffffffffULL) >> 32);
+    return (seconds * 1000000000LL + fractionNS);
+  }
+
+protected:
+  qint64 m_NowNS;
+  PLAYED m_Played;
+
+  virtual qint64 GetClockNS() const { return m_NowNS; }
+
+  virtual void GeneratorClient_Send(bool /*local*/, char *data, size_t size)
+  {
+    sPlayed played;
+    played.sentNS = m_NowNS;
+    played.playedNS = m_NowNS;
+    played.bundled = (size > BUNDLE_HEADER_SIZE && memcmp(data, "#bundle", 8) == 0);
+    if (played.bundled)
+    {
+      // a time tag already passed plays on arrival
+      qint64 atNS = (GetUnixNS(qFromBigEndian<quint64>(data + 8)) - SIMULATED_UNIX_NS);
+      played.playedNS = qMax(atNS, m_NowNS);
+    }
+
+    quint32 bits = qFromBigEndian<quint32>(data + size - 4);
+    memcpy(&played.value, &bits, 4);
+    m_Played.push_back(played);
+    delete[] data;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+class TestTimeTag : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void epochOffset();
+  void secondsAndFraction();
+  void bundleLayout();
+  void dueNowIsNotBundled();
+  void localIsNotBundled();
+  void timeTagRoundTrip();
+  void metroPlaysOnTime();
+  void sinePlaysOnTime();
+
+private:
+  static qint64 GetJitteredStepNS(unsigned int n);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+QByteArray ReceiverHarness::GetMessage(float value)
+{
+  // "/metro" ",f" value, already padded the way the templates build it
+  static const char msg[] = {'/', 'm', 'e', 't', 'r', 'o', 0, 0, ',', 'f', 0, 0, 0, 0, 0, 0};
+  QByteArray ba(msg, sizeof(msg));
+  quint32 bits = 0;
+  memcpy(&bits, &value, 4);
+  qToBigEndian(bits, ba.data() + ba.size() - 4);
+  return ba;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::initTestCase()
+{
+  Wavetable::Init();
+  OSCAddressTable::Instantiate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::cleanupTestCase()
+{
+  OSCAddressTable::Shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+qint64 TestTimeTag::GetJitteredStepNS(unsigned int n)
+{
+  // 1 to 40 ms, in an order that never lines up with the segment length
+  return ((1 + ((n * 7919) % 40)) * 1000000LL + (n % 13) * 1013);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::epochOffset()
+{
+  QCOMPARE(GeneratorThread::GetTimeTag(0), static_cast<quint64>(NTP_UNIX_OFFSET << 32));
+
+  // 2026-01-01T00:00:00Z
+  quint64 timeTag = GeneratorThread::GetTimeTag(1767225600LL * 1000000000LL);
+  QCOMPARE(timeTag >> 32, static_cast<quint64>(3976214400ULL));
+  QCOMPARE(timeTag & 0xffffffffULL, static_cast<quint64>(0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::secondsAndFraction()
+{
+  // the fraction is in units of 2^-32 seconds, truncated
+  quint64 timeTag = GeneratorThread::GetTimeTag(1500000000LL);
+  QCOMPARE(timeTag >> 32, static_cast<quint64>(NTP_UNIX_OFFSET + 1));
+  QCOMPARE(timeTag & 0xffffffffULL, static_cast<quint64>(0x80000000ULL));
+
+  QCOMPARE(GeneratorThread::GetTimeTag(1) & 0xffffffffULL, static_cast<quint64>(4));
+  QCOMPARE(GeneratorThread::GetTimeTag(250000000LL) & 0xffffffffULL, static_cast<quint64>(0x40000000ULL));
+
+  // the last nanosecond of a second must not carry into the seconds
+  timeTag = GeneratorThread::GetTimeTag(999999999LL);
+  QCOMPARE(timeTag >> 32, static_cast<quint64>(NTP_UNIX_OFFSET));
+  QCOMPARE(timeTag & 0xffffffffULL, static_cast<quint64>(4294967291ULL));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::bundleLayout()
+{
+  BundleHarness harness;
+  QByteArray msg(ReceiverHarness::GetMessage(1.0f));
+  qint64 atNS = (harness.GetNowNS() + 60000000000LL);
+  harness.Send(/*local*/ false, msg, atNS);
+
+  QCOMPARE(harness.GetSent().size(), static_cast<size_t>(1));
+  const BundleHarness::sSent &sent = harness.GetSent()[0];
+  QVERIFY(!sent.local);
+
+  // "#bundle\0", 8 byte big endian time tag, then each element prefixed with its 4 byte big endian size
+  const QByteArray &bundle = sent.data;
+  QCOMPARE(bundle.size(), static_cast<qsizetype>(GeneratorThread::BUNDLE_HEADER_SIZE + 4 + msg.size()));
+  QVERIFY((bundle.size() % 4) == 0);
+  QCOMPARE(bundle.left(8), QByteArray("#bundle", 8));
+  QCOMPARE(qFromBigEndian<quint64>(bundle.constData() + 8), GeneratorThread::GetTimeTag(harness.GetUnixOffsetNS() + atNS));
+  QCOMPARE(qFromBigEndian<quint32>(bundle.constData() + GeneratorThread::BUNDLE_HEADER_SIZE), static_cast<quint32>(msg.size()));
+  QCOMPARE(bundle.mid(GeneratorThread::BUNDLE_HEADER_SIZE + 4), msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::dueNowIsNotBundled()
+{
+  BundleHarness harness;
+  QByteArray msg(ReceiverHarness::GetMessage(1.0f));
+  harness.Send(/*local*/ false, msg, harness.GetNowNS() - 1);
+
+  QCOMPARE(harness.GetSent().size(), static_cast<size_t>(1));
+  QCOMPARE(harness.GetSent()[0].data, msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::localIsNotBundled()
+{
+  BundleHarness harness;
+  QByteArray msg(ReceiverHarness::GetMessage(1.0f));
+  harness.Send(/*local*/ true, msg, harness.GetNowNS() + 60000000000LL);
+
+  QCOMPARE(harness.GetSent().size(), static_cast<size_t>(1));
+  QVERIFY(harness.GetSent()[0].local);
+  QCOMPARE(harness.GetSent()[0].data, msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::timeTagRoundTrip()
+{
+  for (qint64 ns = 0; ns < 3000000000LL; ns += 999983)
+    QCOMPARE(ReceiverHarness::GetUnixNS(GeneratorThread::GetTimeTag(SIMULATED_UNIX_NS + ns)), SIMULATED_UNIX_NS + ns);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::metroPlaysOnTime()
+{
+  // 50 ms lookahead covers every uneven step, so each tick plays within a nanosecond
+  // of its segment starting; a longer stall plays the ticks it covered late, by no
+  // more than the stall minus the lookahead, and the ones after it on time again
+  const qint64 lookaheadNS = 50000000LL;
+  const qint64 stallNS = 2000000000LL;
+  ReceiverHarness receiver;
+  receiver.AddGenerator(GeneratorThread::GENERATOR_METRO, 1, 120, static_cast<unsigned int>(lookaheadNS / 1000000), OSCPacketTemplate());
+
+  unsigned int n = 0;
+  while (receiver.GetNowNS() < 30000000000LL)
+    receiver.Advance(GetJitteredStepNS(n++));
+  qint64 stallStartNS = receiver.GetNowNS();
+  receiver.Advance(stallNS);
+  while (receiver.GetNowNS() < 60000000000LL)
+    receiver.Advance(GetJitteredStepNS(n++));
+
+  const ReceiverHarness::PLAYED &played = receiver.GetPlayed();
+  QCOMPARE(static_cast<qint64>(played.size()), (receiver.GetNowNS() + lookaheadNS) / SEGMENT_NS);
+
+  int lateCount = 0;
+  for (size_t i = 0; i < played.size(); i++)
+  {
+    qint64 idealNS = (static_cast<qint64>(i + 1) * SEGMENT_NS);
+    int segment = static_cast<int>((i + 1) % GeneratorThread::METRO_SEGMENT_COUNT);
+    QCOMPARE(played[i].value, static_cast<float>(GeneratorThread::GetMetroTickForSegment(segment)));
+
+    qint64 errorNS = (played[i].playedNS - idealNS);
+    QVERIFY2(errorNS >= -1, qPrintable(QString("tick %1 played %2 ns early").arg(i).arg(-errorNS)));
+    if (idealNS > stallStartNS + lookaheadNS && idealNS < stallStartNS + stallNS)
+    {
+      lateCount++;
+      QVERIFY(errorNS <= stallNS - lookaheadNS);
+    }
+    else
+      QVERIFY2(errorNS <= 1, qPrintable(QString("tick %1 played %2 ns late").arg(i).arg(errorNS)));
+  }
+
+  QVERIFY(lateCount >= static_cast<int>((stallNS - lookaheadNS) / SEGMENT_NS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestTimeTag::sinePlaysOnTime()
+{
+  // every sample is stamped for its pass plus the lookahead, late passes and stalls
+  // included, and holds the value for that moment
+  const qint64 lookaheadNS = 20000000LL;
+  const double speed = ((60 / 60000000000.0) * M_PI);
+  OSCPacketTemplate packetTemplate;
+  OSCAddressTable::ID pathId = OAT.Intern(QStringLiteral("/sine"));
+  packetTemplate.Build(pathId, 1);
+  OAT.Release(pathId);
+
+  ReceiverHarness receiver;
+  receiver.AddGenerator(GeneratorThread::GENERATOR_SINE, 10, 60, static_cast<unsigned int>(lookaheadNS / 1000000), packetTemplate);
+
+  unsigned int n = 0;
+  while (receiver.GetNowNS() < 10000000000LL)
+    receiver.Advance(GetJitteredStepNS(n++));
+  receiver.Advance(2000000000LL);
+  while (receiver.GetNowNS() < 20000000000LL)
+    receiver.Advance(GetJitteredStepNS(n++));
+
+  const ReceiverHarness::PLAYED &played = receiver.GetPlayed();
+  QVERIFY(played.size() > 1000);
+
+  for (size_t i = 0; i < played.size(); i++)
+  {
+    QVERIFY(played[i].bundled);
+    QCOMPARE(played[i].playedNS, played[i].sentNS + lookaheadNS);
+
+    double expected = ((sin(speed * played[i].playedNS) + 1) * 0.5);
+    QVERIFY2(qAbs(played[i].value - expected) < 2 * Wavetable::MAX_SINE_ERROR, qPrintable(QString("sample %1 is %2, expected %3").arg(i).arg(played[i].value).arg(expected)));
+
+    // one sample per interval, give or take the millisecond the schedule rounds to,
+    // and no burst of catch-up samples after the stall
+    if (i != 0)
+      QVERIFY(played[i].sentNS - played[i - 1].sentNS >= 9000000LL);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_APPLESS_MAIN(TestTimeTag)
+#include "TestTimeTag.moc"
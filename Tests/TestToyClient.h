@@ -0,0 +1,70 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#ifndef TEST_TOY_CLIENT_H
+#define TEST_TOY_CLIENT_H
+
+#include "Toy.h"
+#include "EosLog.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+// stands in for MainWindow, counting and dropping everything toys send
+class TestToyClient : public Toy::Client
+{
+public:
+  TestToyClient()
+    : m_SendCount(0)
+  {
+  }
+
+  virtual bool ToyClient_Send(bool /*local*/, char *data, size_t /*size*/)
+  {
+    delete[] data;
+    m_SendCount++;
+    return true;
+  }
+
+  virtual bool ToyClient_Send(const OSCPacketTemplate & /*packetTemplate*/, const float * /*values*/, size_t /*count*/)
+  {
+    m_SendCount++;
+    return true;
+  }
+
+  virtual bool ToyClient_SendLocal(const OSCLocalMessage & /*msg*/)
+  {
+    m_SendCount++;
+    return true;
+  }
+
+  virtual void ToyClient_ResourceRelativePathToAbsolute(QString & /*path*/) {}
+  virtual EosLog &ToyClient_Log() { return m_Log; }
+
+  size_t GetSendCount() const { return m_SendCount; }
+
+private:
+  EosLog m_Log;
+  size_t m_SendCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
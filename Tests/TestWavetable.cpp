@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Electronic Theatre Controls, Inc., http://www.etcconnect.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "QtInclude.h"
+#include <QtTest/QtTest>
+#include "Wavetable.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+class TestWavetable : public QObject
+{
+  Q_OBJECT
+
+private slots:
+  void initTestCase();
+  void sineError();
+  void phaseWraps();
+  void phaseWrapsContinuously();
+  void duty();
+  void sineFastPath();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestWavetable::initTestCase()
+{
+  Wavetable::Init();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestWavetable::sineError()
+{
+  // dense sweep over several cycles, including negative ones
+  double maxError = 0;
+  for (int i = 0; i <= 1000000; i++)
+  {
+    double cycles = ((i / 1000000.0) * 3 - 1);
+    float value = Wavetable::Lookup(Wavetable::WAVEFORM_SINE, cycles, 0.5f);
+    double expected = ((sin(cycles * TWO_PI) + 1) * 0.5);
+    maxError = qMax(maxError, qAbs(value - expected));
+  }
+
+  QVERIFY2(maxError < Wavetable::MAX_SINE_ERROR, qPrintable(QString("max error %1").arg(maxError)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestWavetable::phaseWraps()
+{
+  // whole cycles in either direction land on the same sample
+  const double offsets[] = {0, 0.125, 0.25, 0.5, 0.75, 0.9};
+  for (size_t i = 0; i < (sizeof(offsets) / sizeof(offsets[0])); i++)
+  {
+    for (int w = 0; w < Wavetable::WAVEFORM_COUNT; w++)
+    {
+      Wavetable::EnumWaveform waveform = static_cast<Wavetable::EnumWaveform>(w);
+      float value = Wavetable::Lookup(waveform, offsets[i], 0.5f);
+      QCOMPARE(Wavetable::Lookup(waveform, offsets[i] + 1, 0.5f), value);
+      QCOMPARE(Wavetable::Lookup(waveform, offsets[i] - 3, 0.5f), value);
+      QCOMPARE(Wavetable::Lookup(waveform, offsets[i] + 4096, 0.5f), value);
+    }
+  }
+
+  QCOMPARE(Wavetable::Lookup(Wavetable::WAVEFORM_SAW, 1.25, 0.5f), 0.25f);
+  QCOMPARE(Wavetable::Lookup(Wavetable::WAVEFORM_SAW, -0.75, 0.5f), 0.25f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestWavetable::phaseWrapsContinuously()
+{
+  // no step where one cycle ends and the next begins
+  const Wavetable::EnumWaveform waveforms[] = {Wavetable::WAVEFORM_SINE, Wavetable::WAVEFORM_TRIANGLE, Wavetable::WAVEFORM_RANDOM};
+  for (size_t i = 0; i < (sizeof(waveforms) / sizeof(waveforms[0])); i++)
+  {
+    float before = Wavetable::Lookup(waveforms[i], 7 - 1e-9, 0.5f);
+    float after = Wavetable::Lookup(waveforms[i], 7, 0.5f);
+    QVERIFY(qAbs(before - after) < 0.0001f);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestWavetable::duty()
+{
+  // the first half of the shape takes up duty of the cycle
+  QCOMPARE(Wavetable::Lookup(Wavetable::WAVEFORM_TRIANGLE, 0.25, 0.25f), 1.0f);
+  QCOMPARE(Wavetable::Lookup(Wavetable::WAVEFORM_SQUARE, 0.2, 0.25f), 1.0f);
+  QCOMPARE(Wavetable::Lookup(Wavetable::WAVEFORM_SQUARE, 0.3, 0.25f), 0.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TestWavetable::sineFastPath()
+{
+  // the branch-free lookup batched sines use agrees with the general one, edges included
+  for (int i = 0; i <= 100000; i++)
+  {
+    double cycles = ((i / 100000.0) * 3 - 1);
+    QVERIFY(qAbs(Wavetable::LookupSine(cycles) - Wavetable::Lookup(Wavetable::WAVEFORM_SINE, cycles, 0.5f)) < 0.000001f);
+  }
+
+  QVERIFY(qAbs(Wavetable::LookupSine(7 - 1e-17) - Wavetable::LookupSine(7)) < 0.000001f);
+  QVERIFY(qAbs(Wavetable::LookupSine(-1e-17) - 0.5f) < 0.000001f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+QTEST_APPLESS_MAIN(TestWavetable)
+#include "TestWavetable.moc"